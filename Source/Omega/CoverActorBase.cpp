@@ -2,6 +2,7 @@
 
 #include "CoverActorBase.h"
 #include "Components/StaticMeshComponent.h"
+#include "OmegaInteractableRegistry.h"
 
 // Sets default values
 ACoverActorBase::ACoverActorBase()
@@ -10,9 +11,24 @@ ACoverActorBase::ACoverActorBase()
 	PrimaryActorTick.bCanEverTick = false;
 
 	CoverMeshComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("CoverMeshComp"));
+	CoverMeshComp->SetCollisionProfileName(TEXT("Cover"));
 	RootComponent = CoverMeshComp;
 }
 
+void ACoverActorBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	FOmegaInteractableRegistry::Get(GetWorld()).Register(this, EViewTargetState::VTS_COVER);
+}
+
+void ACoverActorBase::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FOmegaInteractableRegistry::Get(GetWorld()).Unregister(this);
+
+	Super::EndPlay(EndPlayReason);
+}
+
 bool ACoverActorBase::GetIsCrouchHeight()
 {
 	return bIsCrouchHeight;
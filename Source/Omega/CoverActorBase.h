@@ -19,6 +19,9 @@ public:
 	bool GetIsCrouchHeight();
 	
 protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UPROPERTY(VisibleAnywhere, Category = "Cover")
 	class UStaticMeshComponent* CoverMeshComp;
 
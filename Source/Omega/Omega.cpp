@@ -2,6 +2,31 @@
 
 #include "Omega.h"
 #include "Modules/ModuleManager.h"
+#include "Engine/World.h"
+#include "Engine/StreamableManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Omega, "Omega" );
- 
\ No newline at end of file
+
+DEFINE_STAT(STAT_OmegaTracesIssued);
+DEFINE_STAT(STAT_OmegaTimersArmed);
+DEFINE_STAT(STAT_OmegaProjectilesAlive);
+
+namespace OmegaObjectQueries
+{
+	const FCollisionObjectQueryParams Reticle(ECC_TO_BITFIELD(ECC_WorldStatic) | ECC_TO_BITFIELD(ECC_WorldDynamic) | ECC_TO_BITFIELD(ECC_Pawn) | ECC_TO_BITFIELD(ECC_PhysicsBody) | ECC_TO_BITFIELD(COLLISION_INTERACTABLE) | ECC_TO_BITFIELD(COLLISION_COVER));
+	const FCollisionObjectQueryParams Cover(ECC_TO_BITFIELD(ECC_WorldStatic) | ECC_TO_BITFIELD(ECC_WorldDynamic) | ECC_TO_BITFIELD(COLLISION_COVER));
+	const FCollisionObjectQueryParams Combat(ECC_TO_BITFIELD(ECC_WorldStatic) | ECC_TO_BITFIELD(ECC_WorldDynamic) | ECC_TO_BITFIELD(ECC_Pawn) | ECC_TO_BITFIELD(ECC_PhysicsBody) | ECC_TO_BITFIELD(COLLISION_COVER));
+}
+
+uint64 OmegaStats::TimersArmed = 0;
+
+bool OmegaNet::IsGameplayAuthority(const UWorld* World)
+{
+	return World && (World->GetNetMode() != NM_Client);
+}
+
+FStreamableManager& OmegaAssets::GetStreamableManager()
+{
+	static FStreamableManager StreamableManager;
+	return StreamableManager;
+}
@@ -3,3 +3,48 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Stats/Stats.h"
+
+struct FStreamableManager;
+
+DECLARE_STATS_GROUP(TEXT("Omega"), STATGROUP_Omega, STATCAT_Advanced);
+
+/** counters shared across the module, the cycle stats are declared next to the code they time */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces Issued"), STAT_OmegaTracesIssued, STATGROUP_Omega, OMEGA_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Timers Armed"), STAT_OmegaTimersArmed, STATGROUP_Omega, OMEGA_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Projectiles Alive"), STAT_OmegaProjectilesAlive, STATGROUP_Omega, OMEGA_API);
+
+/** custom object channels, see [/Script/Engine.CollisionProfile] in DefaultEngine.ini */
+#define COLLISION_PROJECTILE	ECC_GameTraceChannel1
+#define COLLISION_INTERACTABLE	ECC_GameTraceChannel2
+#define COLLISION_COVER			ECC_GameTraceChannel3
+
+/** object types tested by the gameplay traces - none of them include in-flight projectiles */
+namespace OmegaObjectQueries
+{
+	/** reticle/aim camera ray: anything that blocks the view or can be interacted with */
+	extern const FCollisionObjectQueryParams Reticle;
+	/** cover entry and in-cover checks - world geometry too, only cover that's the first blocking hit counts */
+	extern const FCollisionObjectQueryParams Cover;
+	/** hitscan and melee: world geometry, physics bodies, characters and cover */
+	extern const FCollisionObjectQueryParams Combat;
+}
+
+namespace OmegaNet
+{
+	/** damage and impulses are only applied where gameplay is authoritative - predicted shots on clients are cosmetic */
+	OMEGA_API bool IsGameplayAuthority(const UWorld* World);
+}
+
+namespace OmegaStats
+{
+	/** running total of timers armed by gameplay code, the stat counter above only covers a frame - game thread only */
+	extern OMEGA_API uint64 TimersArmed;
+}
+
+namespace OmegaAssets
+{
+	/** the game's streamable manager, weapon content that isn't needed at spawn is streamed in through it */
+	OMEGA_API FStreamableManager& GetStreamableManager();
+}
@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OmegaCharacter.h"
+#include "OmegaGunBase.h"
+#include "OmegaWeaponArchetype.h"
+#include "HAL/MemoryBase.h"
+#include "Stats/Stats.h"
+
+namespace
+{
+	/**
+	 * Passes everything through to the allocator it wraps, counting game thread allocations while armed. Installed over
+	 * GMalloc for the duration of a measurement - it's never destroyed, another thread may still be calling through it.
+	 */
+	class FOmegaCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FOmegaCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+		FMalloc* const Inner;
+		bool bCounting = false;
+		int32 Allocations = 0;
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			if (bCounting && IsInGameThread()) Allocations++;
+			return Inner->Malloc(Count, Alignment);
+		}
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (bCounting && (Count > 0) && IsInGameThread()) Allocations++;
+			return Inner->Realloc(Original, Count, Alignment);
+		}
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim() override { Inner->Trim(); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+	};
+
+	FOmegaCountingMalloc& GetCountingMalloc()
+	{
+		static FOmegaCountingMalloc* CountingMalloc = new FOmegaCountingMalloc(GMalloc);
+		return *CountingMalloc;
+	}
+
+	// one tick of the fixed timestep the loop runs at, the world itself doesn't advance while it does
+	const float TickSeconds = 1.f / 60.f;
+	// a secondary shot every this many ticks, while charges last
+	const int32 SecondaryFireInterval = 10;
+	const int32 MaxTicks = 10000;
+}
+
+/**
+ * Holds the trigger on the player's gun and runs the character, reticle and weapon ticks directly until the clip is
+ * empty, with secondary shots spending charges along the way. The first half of the clip warms everything up, any
+ * allocation during the second half fails the test.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FOmegaSteadyStateAllocationCommand, FAutomationTestBase*, Test);
+
+bool FOmegaSteadyStateAllocationCommand::Update()
+{
+	AOmegaCharacter* character = OmegaTests::GetPlayerCharacter();
+	AOmegaGunBase* weapon = (character) ? character->GetCurrentWeapon() : nullptr;
+	if (!weapon)
+	{
+		if (character) Test->AddError(TEXT("the player has no weapon in hand"));
+		return true;
+	}
+
+	// full-auto hitscan with no sounds - audio and actor spawns allocate by design and aren't what's under test here.
+	// the clip is doubled so the warm-up and the measured half are each a full magazine of the original gun
+	UOmegaWeaponArchetype* savedArchetype = weapon->Archetype;
+	UOmegaWeaponArchetype* tuning = NewObject<UOmegaWeaponArchetype>(GetTransientPackage(), NAME_None, RF_Transient, const_cast<UOmegaWeaponArchetype*>(weapon->GetArchetype()));
+	tuning->AddToRoot();
+	tuning->ProjectileClass = nullptr;
+	tuning->SecondaryProjectileClass = nullptr;
+	tuning->PrimaryFireSound = nullptr;
+	tuning->SecondaryFireSound = nullptr;
+	tuning->TriggerConfig = EFireMode::FM_Auto;
+	const int32 magazine = FMath::Max(tuning->clipAmmoMax, 1);
+	tuning->clipAmmoMax = magazine * 2;
+	tuning->totalAmmoMax = FMath::Max(tuning->totalAmmoMax, tuning->clipAmmoMax);
+	tuning->clipSecondaryChargeMax = FMath::Max(tuning->clipSecondaryChargeMax, 2);
+	weapon->SetArchetype(tuning);
+	weapon->currentClipAmmo = tuning->clipAmmoMax;
+	weapon->currentGunAmmo = tuning->totalAmmoMax;
+	weapon->currentSecondaryCharges = tuning->clipSecondaryChargeMax;
+
+	// the HUD's bindings are content, not the paths under test
+	const FOmegaAmmoChangedSignature savedAmmoChanged = weapon->OnAmmoChanged;
+	const FOmegaChargeCountChangedSignature savedChargeCountChanged = weapon->OnChargeCountChanged;
+	const FOmegaReticleStateChangedSignature savedReticleStateChanged = character->OnReticleStateChanged;
+	const FOmegaVitalChangedSignature savedHealthChanged = character->OnHealthChanged;
+	const FOmegaVitalChangedSignature savedShieldChanged = character->OnShieldChanged;
+	weapon->OnAmmoChanged.Clear();
+	weapon->OnChargeCountChanged.Clear();
+	character->OnReticleStateChanged.Clear();
+	character->OnHealthChanged.Clear();
+	character->OnShieldChanged.Clear();
+
+#if STATS
+	if (FThreadStats::IsCollectingData()) Test->AddWarning(TEXT("stats are being collected, their messages allocate and are counted too"));
+#endif
+
+	FOmegaCountingMalloc& counter = GetCountingMalloc();
+	FMalloc* const previousMalloc = GMalloc;
+	GMalloc = &counter;
+
+	int32 ticks = 0;
+	int32 warmupTicks = 0;
+	int32 shots = 0;
+	int32 secondaryShots = 0;
+
+	weapon->IsTriggerHeld = true;
+	character->UpdateReticleState();
+	weapon->PrimaryFire(character->GetAimLocation());
+
+	for (; (ticks < MaxTicks) && (weapon->currentClipAmmo > 0); ticks++)
+	{
+		// second half of the clip, everything has been through once
+		if (!counter.bCounting && (weapon->currentClipAmmo <= magazine))
+		{
+			warmupTicks = ticks;
+			shots = 0;
+			secondaryShots = 0;
+			counter.Allocations = 0;
+			counter.bCounting = true;
+		}
+
+		const int32 clipBefore = weapon->currentClipAmmo;
+
+		character->TickActor(TickSeconds, LEVELTICK_All, character->PrimaryActorTick);
+		character->UpdateReticleState();
+		weapon->TickActor(TickSeconds, LEVELTICK_All, weapon->PrimaryActorTick);
+
+		if (((ticks % SecondaryFireInterval) == 0) && (weapon->currentSecondaryCharges > 1) && weapon->SecondaryFire(character->GetAimLocation())) secondaryShots++;
+
+		shots += clipBefore - weapon->currentClipAmmo;
+	}
+
+	counter.bCounting = false;
+	GMalloc = previousMalloc;
+
+	weapon->IsTriggerHeld = false;
+	weapon->OnAmmoChanged = savedAmmoChanged;
+	weapon->OnChargeCountChanged = savedChargeCountChanged;
+	character->OnReticleStateChanged = savedReticleStateChanged;
+	character->OnHealthChanged = savedHealthChanged;
+	character->OnShieldChanged = savedShieldChanged;
+	weapon->SetArchetype(savedArchetype);
+	tuning->RemoveFromRoot();
+
+	if (ticks >= MaxTicks) Test->AddError(FString::Printf(TEXT("the clip never emptied in %d ticks"), MaxTicks));
+	if (shots == 0) Test->AddError(TEXT("no shots were fired in the measured half of the clip"));
+
+	const int32 measuredTicks = ticks - warmupTicks;
+	if (counter.Allocations > 0)
+	{
+		Test->AddError(FString::Printf(TEXT("%d allocations over %d ticks, %d shots and %d secondary shots in steady state"), counter.Allocations, measuredTicks, shots, secondaryShots));
+	}
+	else
+	{
+		Test->AddInfo(FString::Printf(TEXT("no allocations over %d ticks, %d shots and %d secondary shots in steady state"), measuredTicks, shots, secondaryShots));
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmegaSteadyStateAllocationTest, "Omega.Allocations.SteadyStateFiring", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FOmegaSteadyStateAllocationTest::RunTest(const FString& Parameters)
+{
+	OmegaAddLoadTestMapCommands(this);
+	ADD_LATENT_AUTOMATION_COMMAND(FOmegaSteadyStateAllocationCommand(this));
+	return true;
+}
+
+#endif
@@ -3,6 +3,11 @@
 #include "OmegaAmmoPickup.h"
 #include "OmegaCharacter.h"
 
+AOmegaAmmoPickup::AOmegaAmmoPickup()
+{
+	ReticleTag = EViewTargetState::VTS_AMMO;
+}
+
 void AOmegaAmmoPickup::Pickup(AOmegaCharacter * ActingPlayer)
 {
 	ActingPlayer->RegainAmmo(AmmoValue);
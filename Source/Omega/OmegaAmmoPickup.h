@@ -16,6 +16,8 @@ protected:
 	int32 AmmoValue = 50.f;
 
 public:
+	AOmegaAmmoPickup();
+
 	UFUNCTION(BlueprintCallable, Category = "Pickup")
 	virtual void Pickup(class AOmegaCharacter* ActingPlayer) override;
 };
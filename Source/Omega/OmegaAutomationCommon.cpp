@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OmegaCharacter.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/CommandLine.h"
+#include "Tests/AutomationCommon.h"
+
+FString OmegaTests::GetTestMap()
+{
+	FString map = TEXT("/Game/FirstPersonCPP/Maps/DemoLevel");
+	FParse::Value(FCommandLine::Get(), TEXT("OmegaTestMap="), map);
+	return map;
+}
+
+UWorld* OmegaTests::GetGameWorld()
+{
+	for (const FWorldContext& context : GEngine->GetWorldContexts())
+	{
+		if (((context.WorldType == EWorldType::PIE) || (context.WorldType == EWorldType::Game)) && context.World()) return context.World();
+	}
+	return nullptr;
+}
+
+AOmegaCharacter* OmegaTests::GetPlayerCharacter()
+{
+	UWorld* world = GetGameWorld();
+	APlayerController* controller = (world) ? world->GetFirstPlayerController() : nullptr;
+	return (controller) ? Cast<AOmegaCharacter>(controller->GetPawn()) : nullptr;
+}
+
+void OmegaAddLoadTestMapCommands(FAutomationTestBase* Test)
+{
+	AutomationOpenMap(OmegaTests::GetTestMap());
+	ADD_LATENT_AUTOMATION_COMMAND(FOmegaWaitForPlayerCommand(Test, 30.f));
+}
+
+bool FOmegaWaitForPlayerCommand::Update()
+{
+	if (OmegaTests::GetPlayerCharacter()) return true;
+	if (GetCurrentRunTime() < Timeout) return false;
+
+	Test->AddError(FString::Printf(TEXT("no player character spawned on %s within %.0fs"), *OmegaTests::GetTestMap(), Timeout));
+	return true;
+}
+
+#endif
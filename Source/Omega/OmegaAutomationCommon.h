@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class UWorld;
+class AOmegaCharacter;
+
+/** shared setup for the gameplay automation tests, they run in the game world on the test map */
+namespace OmegaTests
+{
+	/** the map the gameplay tests load, -OmegaTestMap= overrides it */
+	FString GetTestMap();
+	/** the running game or PIE world, null while no map is up */
+	UWorld* GetGameWorld();
+	/** the first local player's character, null until it has spawned */
+	AOmegaCharacter* GetPlayerCharacter();
+}
+
+/** opens the test map and waits for the local player's character, latent commands added after it can rely on one */
+void OmegaAddLoadTestMapCommands(FAutomationTestBase* Test);
+
+/** waits for the local player's character, fails the test after Timeout seconds without one */
+DEFINE_LATENT_AUTOMATION_COMMAND_TWO_PARAMETER(FOmegaWaitForPlayerCommand, FAutomationTestBase*, Test, float, Timeout);
+
+#endif
@@ -0,0 +1,420 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaBenchmark.h"
+#include "OmegaCharacter.h"
+#include "OmegaGunBase.h"
+#include "OmegaWeaponArchetype.h"
+#include "OmegaProjectile.h"
+#include "OmegaAmmoPickup.h"
+#include "CoverActorBase.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/EngineVersion.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmegaBenchmark, Log, All);
+
+namespace
+{
+	const TCHAR* const CaseNames[] =
+	{
+		TEXT("reticle"),
+		TEXT("hitscan_auto"),
+		TEXT("projectile_spawn_expire"),
+		TEXT("in_cover"),
+		TEXT("pickup_overlap"),
+		TEXT("weapon_swap")
+	};
+	static_assert(ARRAY_COUNT(CaseNames) == (int32)EOmegaBenchmarkCase::Num, "every benchmark case needs a name");
+
+	float Percentile(const TArray<float>& Sorted, float Fraction)
+	{
+		if (Sorted.Num() == 0) return 0.f;
+		return Sorted[FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+	}
+}
+
+void AOmegaBenchmark::WriteSummary(TJsonWriter<>& Writer, const TCHAR* Name, const TArray<float>& Values)
+{
+	TArray<float> sorted = Values;
+	sorted.Sort();
+
+	float total = 0.f;
+	for (float value : sorted) total += value;
+
+	Writer.WriteObjectStart(Name);
+	Writer.WriteValue(TEXT("mean"), (sorted.Num() > 0) ? total / sorted.Num() : 0.f);
+	Writer.WriteValue(TEXT("p50"), Percentile(sorted, 0.5f));
+	Writer.WriteValue(TEXT("p99"), Percentile(sorted, 0.99f));
+	Writer.WriteValue(TEXT("max"), (sorted.Num() > 0) ? sorted.Last() : 0.f);
+	Writer.WriteObjectEnd();
+}
+
+AOmegaBenchmark::AOmegaBenchmark()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	CoverClass = ACoverActorBase::StaticClass();
+	PickupClass = AOmegaAmmoPickup::StaticClass();
+}
+
+const TCHAR* AOmegaBenchmark::GetCaseName(EOmegaBenchmarkCase Case)
+{
+	return ((int32)Case < (int32)EOmegaBenchmarkCase::Num) ? CaseNames[(int32)Case] : TEXT("none");
+}
+
+FString AOmegaBenchmark::DescribeCase(EOmegaBenchmarkCase Case) const
+{
+	if ((int32)Case >= (int32)EOmegaBenchmarkCase::Num) return FString();
+
+	TArray<float> systemMs = Samples[(int32)Case].SystemMs;
+	TArray<float> frameMs = Samples[(int32)Case].FrameMs;
+	systemMs.Sort();
+	frameMs.Sort();
+
+	return FString::Printf(TEXT("%s: %d characters, %d frames, system p50 %.3f ms p99 %.3f ms, frame p50 %.3f ms p99 %.3f ms"), GetCaseName(Case), Characters.Num(),
+		systemMs.Num(), Percentile(systemMs, 0.5f), Percentile(systemMs, 0.99f), Percentile(frameMs, 0.5f), Percentile(frameMs, 0.99f));
+}
+
+AOmegaBenchmark* AOmegaBenchmark::Start(UWorld* World, int32 NumCharacters, int32 FramesPerCase, bool bQuitWhenDone, EOmegaBenchmarkCase OnlyCase)
+{
+	if (!World) return nullptr;
+
+	for (TActorIterator<AOmegaBenchmark> It(World); It; ++It)
+	{
+		UE_LOG(LogOmegaBenchmark, Warning, TEXT("a benchmark is already running"));
+		return *It;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AOmegaBenchmark* Benchmark = World->SpawnActor<AOmegaBenchmark>(SpawnParams);
+	if (!Benchmark) return nullptr;
+
+	Benchmark->NumCharacters = FMath::Max(NumCharacters, 1);
+	Benchmark->FramesPerCase = FMath::Max(FramesPerCase, 1);
+	Benchmark->bQuitWhenDone = bQuitWhenDone;
+	Benchmark->OnlyCase = OnlyCase;
+	if (OnlyCase != EOmegaBenchmarkCase::Num) Benchmark->CurrentCase = OnlyCase;
+	Benchmark->SpawnCharacters();
+	Benchmark->BeginCase();
+
+	UE_LOG(LogOmegaBenchmark, Log, TEXT("running %d cases, %d characters, %d frames each"), (OnlyCase != EOmegaBenchmarkCase::Num) ? 1 : (int32)EOmegaBenchmarkCase::Num, Benchmark->NumCharacters, Benchmark->FramesPerCase);
+	return Benchmark;
+}
+
+void AOmegaBenchmark::SpawnCharacters()
+{
+	UWorld* const World = GetWorld();
+
+	// the game's own pawn, so the guns and tuning are the ones players get
+	UClass* characterClass = AOmegaCharacter::StaticClass();
+	const AGameModeBase* gameMode = World->GetAuthGameMode();
+	if (gameMode && gameMode->DefaultPawnClass && gameMode->DefaultPawnClass->IsChildOf(AOmegaCharacter::StaticClass())) characterClass = gameMode->DefaultPawnClass;
+
+	// a line across the local player's view, everyone facing +X so nobody is in anybody's line of fire
+	APlayerController* playerController = World->GetFirstPlayerController();
+	const FVector origin = (playerController && playerController->GetPawn()) ? playerController->GetPawn()->GetActorLocation() + FVector(CharacterSpacing, 0.f, 0.f) : FVector::ZeroVector;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	for (int32 index = 0; index < NumCharacters; index++)
+	{
+		const FVector location = origin + FVector(0.f, (index - NumCharacters / 2) * CharacterSpacing, 0.f);
+		AOmegaCharacter* character = World->SpawnActor<AOmegaCharacter>(characterClass, location, FRotator::ZeroRotator, SpawnParams);
+		if (character) Characters.Add(character);
+	}
+}
+
+void AOmegaBenchmark::BeginCase()
+{
+	CaseFrame = -WarmupFrames;
+	LastFrameTime = 0.0;
+
+	// debug lines aren't part of what the hitscan case measures
+	if (CurrentCase == EOmegaBenchmarkCase::Hitscan)
+	{
+		if (IConsoleVariable* drawHitscan = IConsoleManager::Get().FindConsoleVariable(TEXT("Omega.DrawHitscan")))
+		{
+			SavedDrawHitscan = drawHitscan->GetInt();
+			drawHitscan->Set(0, ECVF_SetByConsole);
+		}
+	}
+
+	UWorld* const World = GetWorld();
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (AOmegaCharacter* character : Characters)
+	{
+		// case actors line up with the characters by index
+		if (!character)
+		{
+			CaseActors.Add(nullptr);
+			continue;
+		}
+
+		const FVector location = character->GetActorLocation();
+
+		if ((CurrentCase == EOmegaBenchmarkCase::InCover) && CoverClass)
+		{
+			CaseActors.Add(World->SpawnActor<AActor>(CoverClass, location + FVector(150.f, 0.f, 0.f), FRotator::ZeroRotator, SpawnParams));
+		}
+		else if ((CurrentCase == EOmegaBenchmarkCase::PickupOverlap) && PickupClass)
+		{
+			// parked well below the character, moved onto it on alternating frames
+			CaseActors.Add(World->SpawnActor<AActor>(PickupClass, location - FVector(0.f, 0.f, 10000.f), FRotator::ZeroRotator, SpawnParams));
+		}
+	}
+}
+
+void AOmegaBenchmark::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (CurrentCase == EOmegaBenchmarkCase::Num) return;
+
+	RunCase(DeltaSeconds);
+
+	if (++CaseFrame < FramesPerCase) return;
+
+	EndCase();
+	CurrentCase = (OnlyCase != EOmegaBenchmarkCase::Num) ? EOmegaBenchmarkCase::Num : (EOmegaBenchmarkCase)((int32)CurrentCase + 1);
+
+	if (CurrentCase == EOmegaBenchmarkCase::Num) Finish();
+	else BeginCase();
+}
+
+void AOmegaBenchmark::RunCase(float DeltaSeconds)
+{
+	// untimed setup for the frame - putting characters back into the state the case measures
+	if (CurrentCase == EOmegaBenchmarkCase::InCover)
+	{
+		for (AOmegaCharacter* character : Characters)
+		{
+			if (!character || (character->CoverState == ECoverState::CS_COVER)) continue;
+
+			character->EnterCover();
+			if (character->CoverActor) character->CoverState = ECoverState::CS_COVER;
+		}
+	}
+	else if (CurrentCase == EOmegaBenchmarkCase::Hitscan)
+	{
+		for (AOmegaCharacter* character : Characters)
+		{
+			if (!character || !character->CurrentWeapon) continue;
+
+			// guns show up on the characters' first ticks, they're armed during the warmup
+			character->UpdateReticleState();
+			if (!HitscanWeapons.Contains(character->CurrentWeapon)) ArmHitscanWeapon(character);
+			character->CurrentWeapon->currentClipAmmo = character->CurrentWeapon->GetArchetype()->clipAmmoMax;
+		}
+	}
+
+	const uint32 startCycles = FPlatformTime::Cycles();
+
+	for (int32 index = 0; index < Characters.Num(); index++)
+	{
+		AOmegaCharacter* character = Characters[index];
+		if (!character || character->IsPendingKill()) continue;
+
+		AOmegaGunBase* weapon = character->CurrentWeapon;
+
+		switch (CurrentCase)
+		{
+		case EOmegaBenchmarkCase::Reticle:
+			character->UpdateReticleState();
+			break;
+
+		case EOmegaBenchmarkCase::Hitscan:
+			// the world doesn't tick armed guns, this is their whole fire schedule - every shot that came due this frame
+			if (weapon && weapon->bTickedExternally) weapon->TickActor(DeltaSeconds, LEVELTICK_All, weapon->PrimaryActorTick);
+			break;
+
+		case EOmegaBenchmarkCase::Projectiles:
+			// spawn cost is timed here, flight and expiry show up in the frame time
+			if (weapon)
+			{
+				TSubclassOf<AOmegaProjectile> projectileClass = weapon->GetArchetype()->ProjectileClass;
+				weapon->FireProjectile((projectileClass) ? projectileClass : TSubclassOf<AOmegaProjectile>(AOmegaProjectile::StaticClass()),
+					character->GetActorLocation() + character->GetActorForwardVector() * 5000.f);
+			}
+			break;
+
+		case EOmegaBenchmarkCase::InCover:
+			if ((character->CoverState == ECoverState::CS_COVER) && character->CoverActor) character->HandleInCover();
+			break;
+
+		case EOmegaBenchmarkCase::PickupOverlap:
+			// the move runs the overlap update and the pickup's begin/end overlap handlers
+			if (CaseActors.IsValidIndex(index) && CaseActors[index])
+			{
+				const FVector offset = (CaseFrame & 1) ? FVector(0.f, 0.f, -10000.f) : FVector::ZeroVector;
+				CaseActors[index]->SetActorLocation(character->GetActorLocation() + offset);
+			}
+			break;
+
+		case EOmegaBenchmarkCase::WeaponSwap:
+			character->StartWeaponSwap();
+			character->GetWorldTimerManager().ClearTimer(character->WeaponSwapTimerHandle);
+			character->FinishWeaponSwap();
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	const float systemMs = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - startCycles);
+	const double now = FPlatformTime::Seconds();
+
+	if ((CaseFrame >= 0) && (LastFrameTime > 0.0))
+	{
+		FCaseSamples& caseSamples = Samples[(int32)CurrentCase];
+		caseSamples.SystemMs.Add(systemMs);
+		caseSamples.FrameMs.Add((float)((now - LastFrameTime) * 1000.0));
+	}
+	LastFrameTime = now;
+}
+
+void AOmegaBenchmark::EndCase()
+{
+	for (AActor* actor : CaseActors)
+	{
+		if (actor) actor->Destroy();
+	}
+	CaseActors.Reset();
+
+	if (CurrentCase == EOmegaBenchmarkCase::Hitscan) DisarmHitscanWeapons();
+
+	for (AOmegaCharacter* character : Characters)
+	{
+		if (character && (character->CoverState != ECoverState::CS_NONE)) character->ExitCover();
+	}
+
+	UE_LOG(LogOmegaBenchmark, Log, TEXT("%s"), *DescribeCase(CurrentCase));
+}
+
+void AOmegaBenchmark::ArmHitscanWeapon(AOmegaCharacter* Character)
+{
+	AOmegaGunBase* weapon = Character->CurrentWeapon;
+
+	// full-auto hitscan at about a shot a frame, with a clip RunCase keeps topped up
+	const UOmegaWeaponArchetype* source = weapon->GetArchetype();
+	UOmegaWeaponArchetype* tuning = NewObject<UOmegaWeaponArchetype>(this, source->GetClass(), NAME_None, RF_Transient, const_cast<UOmegaWeaponArchetype*>(source));
+	tuning->ProjectileClass = nullptr;
+	tuning->TriggerConfig = EFireMode::FM_Auto;
+	tuning->AutoFireRate = FMath::Min(tuning->AutoFireRate, 1.f / 60.f);
+	tuning->clipAmmoMax = FMath::Max(tuning->clipAmmoMax, 1000);
+
+	HitscanWeapons.Add(weapon);
+	HitscanSavedArchetypes.Add(weapon->Archetype);
+	weapon->SetArchetype(tuning);
+	weapon->currentClipAmmo = tuning->clipAmmoMax;
+
+	// RunCase ticks it from here on, so the fire schedule is inside the timing
+	weapon->SetActorTickEnabled(false);
+	weapon->bTickedExternally = true;
+	weapon->IsTriggerHeld = true;
+	weapon->PrimaryFire(Character->GetAimLocation());
+}
+
+void AOmegaBenchmark::DisarmHitscanWeapons()
+{
+	for (int32 index = 0; index < HitscanWeapons.Num(); index++)
+	{
+		AOmegaGunBase* weapon = HitscanWeapons[index];
+		if (!weapon || weapon->IsPendingKill()) continue;
+
+		weapon->IsTriggerHeld = false;
+		weapon->bTickedExternally = false;
+		weapon->SetArchetype(HitscanSavedArchetypes[index]);
+		// back on the world's tick, which puts it to sleep once the fire cycle winds down
+		weapon->SetActorTickEnabled(true);
+	}
+
+	HitscanWeapons.Reset();
+	HitscanSavedArchetypes.Reset();
+
+	if (IConsoleVariable* drawHitscan = IConsoleManager::Get().FindConsoleVariable(TEXT("Omega.DrawHitscan"))) drawHitscan->Set(SavedDrawHitscan, ECVF_SetByConsole);
+}
+
+void AOmegaBenchmark::Finish()
+{
+	WriteResults();
+	OnFinished.Broadcast(*this);
+
+	for (AOmegaCharacter* character : Characters)
+	{
+		if (character) character->Destroy();
+	}
+	Characters.Reset();
+
+	SetActorTickEnabled(false);
+
+	if (bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+		return;
+	}
+
+	Destroy();
+}
+
+void AOmegaBenchmark::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// a map change mid-run leaves nothing behind
+	if (CurrentCase == EOmegaBenchmarkCase::Hitscan) DisarmHitscanWeapons();
+	for (AActor* actor : CaseActors)
+	{
+		if (actor) actor->Destroy();
+	}
+	for (AOmegaCharacter* character : Characters)
+	{
+		if (character) character->Destroy();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AOmegaBenchmark::WriteResults() const
+{
+	FString output;
+	TSharedRef<TJsonWriter<>> writer = TJsonWriterFactory<>::Create(&output);
+
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("engine"), FEngineVersion::Current().ToString());
+	writer->WriteValue(TEXT("build_config"), FString(EBuildConfigurations::ToString(FApp::GetBuildConfiguration())));
+	writer->WriteValue(TEXT("map"), GetWorld()->GetMapName());
+	writer->WriteValue(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	writer->WriteValue(TEXT("characters"), Characters.Num());
+	writer->WriteValue(TEXT("frames_per_case"), FramesPerCase);
+
+	writer->WriteArrayStart(TEXT("cases"));
+	for (int32 index = 0; index < (int32)EOmegaBenchmarkCase::Num; index++)
+	{
+		if ((OnlyCase != EOmegaBenchmarkCase::Num) && (index != (int32)OnlyCase)) continue;
+
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("name"), FString(CaseNames[index]));
+		writer->WriteValue(TEXT("frames"), Samples[index].SystemMs.Num());
+		WriteSummary(*writer, TEXT("system_ms"), Samples[index].SystemMs);
+		WriteSummary(*writer, TEXT("frame_ms"), Samples[index].FrameMs);
+		writer->WriteObjectEnd();
+	}
+	writer->WriteArrayEnd();
+
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	const FString path = FPaths::Combine(FPaths::GameSavedDir(), TEXT("Benchmarks"), FString::Printf(TEXT("OmegaBenchmark-%s.json"), *FDateTime::Now().ToString()));
+	if (FFileHelper::SaveStringToFile(output, *path)) UE_LOG(LogOmegaBenchmark, Log, TEXT("results written to %s"), *path);
+	else UE_LOG(LogOmegaBenchmark, Error, TEXT("couldn't write results to %s"), *path);
+}
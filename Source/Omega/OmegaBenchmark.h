@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "Serialization/JsonWriter.h"
+#include "OmegaBenchmark.generated.h"
+
+class AOmegaCharacter;
+class AOmegaGunBase;
+class UOmegaWeaponArchetype;
+class AOmegaBenchmark;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOmegaBenchmarkFinishedSignature, const AOmegaBenchmark&);
+
+UENUM()
+enum class EOmegaBenchmarkCase : uint8
+{
+	Reticle,
+	Hitscan,
+	Projectiles,
+	InCover,
+	PickupOverlap,
+	WeaponSwap,
+	Num		UMETA(Hidden)
+};
+
+/**
+ * Frame cost benchmark for the gameplay systems. Spawns a grid of characters in the current map and runs each case
+ * for a fixed number of frames, timing the system itself across all characters as well as the whole frame. Results
+ * (mean/p50/p99/max per case) are written as JSON to Saved/Benchmarks so builds can be compared.
+ *
+ * Runs headless: -game -nullrhi -ExecCmds="OmegaBenchmark 32 300 1"
+ * Each case also runs on its own as an automation test, Omega.Benchmark.Systems.
+ */
+UCLASS(config=Game)
+class OMEGA_API AOmegaBenchmark : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AOmegaBenchmark();
+
+	/** starts a run in World unless one is already going, returns the running benchmark - OnlyCase runs just that one */
+	static AOmegaBenchmark* Start(UWorld* World, int32 NumCharacters, int32 FramesPerCase, bool bQuitWhenDone, EOmegaBenchmarkCase OnlyCase = EOmegaBenchmarkCase::Num);
+
+	/** the case's name in the results */
+	static const TCHAR* GetCaseName(EOmegaBenchmarkCase Case);
+
+	/** one line of the case's system and frame timings, for logs and test reports */
+	FString DescribeCase(EOmegaBenchmarkCase Case) const;
+
+	/** fired once the results are written, right before the benchmark goes away */
+	FOmegaBenchmarkFinishedSignature OnFinished;
+
+	/** writes Name: { mean, p50, p99, max } of Values, shared by everything that reports frame timings */
+	static void WriteSummary(TJsonWriter<>& Writer, const TCHAR* Name, const TArray<float>& Values);
+
+protected:
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** cover spawned in front of each character for the in-cover case, needs collision on the cover channel */
+	UPROPERTY(Config)
+	TSubclassOf<class ACoverActorBase> CoverClass;
+	/** pickup moved on and off each character for the overlap case */
+	UPROPERTY(Config)
+	TSubclassOf<class APickup> PickupClass;
+
+	/** frames run before each case starts recording, lets spawns and first-use loads settle */
+	UPROPERTY(Config)
+	int32 WarmupFrames = 10;
+	UPROPERTY(Config)
+	float CharacterSpacing = 400.f;
+
+private:
+	void SpawnCharacters();
+	void BeginCase();
+	void RunCase(float DeltaSeconds);
+	void EndCase();
+	void Finish();
+	void WriteResults() const;
+
+	// the hitscan case holds the trigger on each gun and ticks it from RunCase, so the timing covers the whole fire path -
+	// disarming puts the guns back on the world's tick and restores Omega.DrawHitscan
+	void ArmHitscanWeapon(AOmegaCharacter* Character);
+	void DisarmHitscanWeapons();
+
+	int32 NumCharacters = 16;
+	int32 FramesPerCase = 300;
+	bool bQuitWhenDone = false;
+	EOmegaBenchmarkCase OnlyCase = EOmegaBenchmarkCase::Num;
+
+	UPROPERTY()
+	TArray<AOmegaCharacter*> Characters;
+	// per-case props, destroyed when the case ends
+	UPROPERTY()
+	TArray<AActor*> CaseActors;
+
+	// guns armed for the hitscan case, with the archetypes to put back when it ends
+	UPROPERTY()
+	TArray<AOmegaGunBase*> HitscanWeapons;
+	UPROPERTY()
+	TArray<UOmegaWeaponArchetype*> HitscanSavedArchetypes;
+	int32 SavedDrawHitscan = 0;
+
+	EOmegaBenchmarkCase CurrentCase = EOmegaBenchmarkCase::Reticle;
+	int32 CaseFrame = 0;
+	double LastFrameTime = 0.0;
+
+	struct FCaseSamples
+	{
+		TArray<float> SystemMs;
+		TArray<float> FrameMs;
+	};
+	FCaseSamples Samples[(int32)EOmegaBenchmarkCase::Num];
+};
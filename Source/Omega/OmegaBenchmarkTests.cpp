@@ -0,0 +1,104 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OmegaBenchmark.h"
+#include "OmegaCharacter.h"
+#include "Engine/World.h"
+
+namespace
+{
+	const int32 NumCharacters = 16;
+	const int32 FramesPerCase = 120;
+	// generous, a case is its warmup plus FramesPerCase frames
+	const float Timeout = 120.f;
+}
+
+/** runs a single benchmark case in the game world and reports its timings once the benchmark has finished */
+class FOmegaBenchmarkCaseCommand : public IAutomationLatentCommand
+{
+public:
+	FOmegaBenchmarkCaseCommand(FAutomationTestBase* InTest, EOmegaBenchmarkCase InCase)
+		: Test(InTest)
+		, Case(InCase)
+	{}
+
+	virtual bool Update() override;
+
+private:
+	FAutomationTestBase* Test;
+	EOmegaBenchmarkCase Case;
+	TWeakObjectPtr<AOmegaBenchmark> Benchmark;
+	bool bStarted = false;
+	bool bFinished = false;
+};
+
+bool FOmegaBenchmarkCaseCommand::Update()
+{
+	if (!bStarted)
+	{
+		bStarted = true;
+
+		AOmegaCharacter* character = OmegaTests::GetPlayerCharacter();
+		if (!character) return true;
+
+		Benchmark = AOmegaBenchmark::Start(character->GetWorld(), NumCharacters, FramesPerCase, false, Case);
+		if (!Benchmark.IsValid())
+		{
+			Test->AddError(TEXT("couldn't start the benchmark"));
+			return true;
+		}
+
+		FAutomationTestBase* test = Test;
+		const EOmegaBenchmarkCase benchmarkCase = Case;
+		bool* finished = &bFinished;
+		Benchmark->OnFinished.AddLambda([test, benchmarkCase, finished](const AOmegaBenchmark& Finished)
+		{
+			test->AddInfo(Finished.DescribeCase(benchmarkCase));
+			*finished = true;
+		});
+		return false;
+	}
+
+	// the benchmark destroys itself once it's done, without finishing if the world went away under it
+	if (Benchmark.IsValid() && !bFinished)
+	{
+		if (GetCurrentRunTime() < Timeout) return false;
+
+		Test->AddError(FString::Printf(TEXT("%s didn't finish within %.0fs"), AOmegaBenchmark::GetCaseName(Case), Timeout));
+		Benchmark->Destroy();
+		return true;
+	}
+
+	if (!bFinished) Test->AddError(FString::Printf(TEXT("%s ended before it finished"), AOmegaBenchmark::GetCaseName(Case)));
+	return true;
+}
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FOmegaBenchmarkTest, "Omega.Benchmark.Systems", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FOmegaBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (int32 index = 0; index < (int32)EOmegaBenchmarkCase::Num; index++)
+	{
+		OutBeautifiedNames.Add(AOmegaBenchmark::GetCaseName((EOmegaBenchmarkCase)index));
+		OutTestCommands.Add(FString::FromInt(index));
+	}
+}
+
+bool FOmegaBenchmarkTest::RunTest(const FString& Parameters)
+{
+	const int32 index = FCString::Atoi(*Parameters);
+	if ((index < 0) || (index >= (int32)EOmegaBenchmarkCase::Num))
+	{
+		AddError(FString::Printf(TEXT("no benchmark case %s"), *Parameters));
+		return false;
+	}
+
+	OmegaAddLoadTestMapCommands(this);
+	ADD_LATENT_AUTOMATION_COMMAND(FOmegaBenchmarkCaseCommand(this, (EOmegaBenchmarkCase)index));
+	return true;
+}
+
+#endif
@@ -0,0 +1,397 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaBotController.h"
+#include "Omega.h"
+#include "OmegaGunBase.h"
+#include "OmegaInteractableRegistry.h"
+#include "Pickup.h"
+#include "AI/Navigation/NavigationSystem.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+AOmegaBotController::AOmegaBotController()
+{
+	// bots show up on the scoreboard and in telemetry like players
+	bWantsPlayerState = true;
+}
+
+void AOmegaBotController::Possess(APawn* InPawn)
+{
+	Super::Possess(InPawn);
+
+	Bot = Cast<AOmegaCharacter>(InPawn);
+	Enemy = nullptr;
+	Random.Initialize(FMath::Rand());
+
+	// spread the bots' fire mode changes out
+	NextFireModeTime = GetWorld()->GetTimeSeconds() + Random.FRandRange(0.f, FireModeInterval);
+	SetState(EOmegaBotState::Roam);
+}
+
+void AOmegaBotController::UnPossess()
+{
+	ReleaseTrigger();
+	StopMoving();
+	Bot = nullptr;
+	Enemy = nullptr;
+	Goal = nullptr;
+
+	Super::UnPossess();
+}
+
+void AOmegaBotController::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (!Bot) return;
+
+	// the game mode respawns it
+	if (Bot->IsDead())
+	{
+		ReleaseTrigger();
+		StopMoving();
+		ClearFocus(EAIFocusPriority::Gameplay);
+		return;
+	}
+
+	const float now = GetWorld()->GetTimeSeconds();
+	if (bIsTriggerHeld && (now >= TriggerReleaseTime)) ReleaseTrigger();
+
+	if (bSteering)
+	{
+		FVector toTarget = MoveTarget - Bot->GetActorLocation();
+		toTarget.Z = 0.f;
+		if (toTarget.SizeSquared() > FMath::Square(100.f)) Bot->AddMovementInput(toTarget.GetSafeNormal());
+		else bSteering = false;
+	}
+
+	if (now >= NextThinkTime)
+	{
+		NextThinkTime = now + ThinkInterval;
+		Think();
+	}
+}
+
+void AOmegaBotController::Think()
+{
+	AOmegaGunBase* weapon = Bot->GetCurrentWeapon();
+	const float now = GetWorld()->GetTimeSeconds();
+
+	// a dry gun reloads before anything else
+	if (weapon && (weapon->currentClipAmmo <= 0) && (weapon->currentGunAmmo > 0) && !weapon->IsReloading())
+	{
+		ReleaseTrigger();
+		Bot->StartReload();
+	}
+
+	if (now >= NextFireModeTime)
+	{
+		NextFireModeTime = now + FireModeInterval;
+		CycleFireMode();
+	}
+
+	if (!bIsTriggerHeld && (Random.FRand() < WeaponSwapChance)) Bot->StartWeaponSwap();
+
+	Enemy = FindEnemy();
+
+	if (State == EOmegaBotState::TakeCover)
+	{
+		ThinkTakeCover();
+		return;
+	}
+
+	if (Enemy)
+	{
+		if (State != EOmegaBotState::Engage) SetState(EOmegaBotState::Engage);
+		ThinkEngage();
+		return;
+	}
+
+	if (State == EOmegaBotState::Engage) SetState(EOmegaBotState::Roam);
+
+	if (State != EOmegaBotState::Collect)
+	{
+		AActor* pickup = FindInteractable([](EViewTargetState Tag)
+		{
+			return (Tag == EViewTargetState::VTS_AMMO) || (Tag == EViewTargetState::VTS_HEALTH) || (Tag == EViewTargetState::VTS_OBJECT);
+		});
+		if (pickup) SetState(EOmegaBotState::Collect, pickup);
+	}
+
+	if (State == EOmegaBotState::Collect) ThinkCollect();
+	else ThinkRoam();
+}
+
+void AOmegaBotController::ThinkEngage()
+{
+	const float now = GetWorld()->GetTimeSeconds();
+	SetFocus(Enemy);
+
+	// sometimes break off to fight from cover
+	if (Random.FRand() < CoverChance)
+	{
+		AActor* cover = FindInteractable([](EViewTargetState Tag) { return Tag == EViewTargetState::VTS_COVER; });
+		if (cover)
+		{
+			SetState(EOmegaBotState::TakeCover, cover);
+			return;
+		}
+	}
+
+	PullTrigger();
+
+	// strafe while shooting
+	if (now >= StateEndTime)
+	{
+		StateEndTime = now + Random.FRandRange(1.f, 3.f);
+		MoveTowards(Bot->GetActorLocation() + Bot->GetActorRightVector() * Random.FRandRange(-600.f, 600.f), 50.f);
+	}
+}
+
+void AOmegaBotController::ThinkTakeCover()
+{
+	const float now = GetWorld()->GetTimeSeconds();
+
+	if (!Goal || Goal->IsPendingKill())
+	{
+		if (Bot->CoverState != ECoverState::CS_NONE) Bot->ExitCover();
+		SetState(EOmegaBotState::Roam);
+		return;
+	}
+
+	if (Bot->CoverState == ECoverState::CS_NONE)
+	{
+		if (now >= StateEndTime)
+		{
+			SetState(EOmegaBotState::Roam);
+			return;
+		}
+
+		const FVector coverLocation = Goal->GetActorLocation();
+		SetFocalPoint(coverLocation);
+
+		if (FVector::Dist2D(Bot->GetActorLocation(), coverLocation) > Bot->CoverInteractDistance * 0.5f)
+		{
+			if (!bSteering && (GetMoveStatus() == EPathFollowingStatus::Idle)) MoveTowards(coverLocation, Bot->CoverInteractDistance * 0.4f);
+			return;
+		}
+
+		// facing the cover, the same call the Action binding makes with cover under the reticle
+		StopMoving();
+		Bot->EnterCover();
+		if (Bot->CoverState != ECoverState::CS_NONE) StateEndTime = now + CoverTime;
+		return;
+	}
+
+	// in cover: shoot at whoever shows up, leave when the time's up
+	if (Enemy)
+	{
+		SetFocus(Enemy);
+		PullTrigger();
+	}
+
+	if (now >= StateEndTime)
+	{
+		Bot->ExitCover();
+		SetState(EOmegaBotState::Roam);
+	}
+}
+
+void AOmegaBotController::ThinkCollect()
+{
+	APickup* pickup = Cast<APickup>(Goal);
+	if (!pickup || pickup->IsPendingKill() || (GetWorld()->GetTimeSeconds() >= StateEndTime))
+	{
+		SetState(EOmegaBotState::Roam);
+		return;
+	}
+
+	SetFocalPoint(pickup->GetActorLocation());
+
+	// standing on it with it under the reticle, which is what Action needs
+	const EViewTargetState reticle = Bot->GetReticleState();
+	const bool bPickupUnderReticle = (reticle == EViewTargetState::VTS_AMMO) || (reticle == EViewTargetState::VTS_HEALTH) || (reticle == EViewTargetState::VTS_OBJECT);
+	if (Bot->IsOverlappingPickup && Bot->OverlappedPickupRef && bPickupUnderReticle)
+	{
+		Bot->Action();
+		SetState(EOmegaBotState::Roam);
+		return;
+	}
+
+	if (!bSteering && (GetMoveStatus() == EPathFollowingStatus::Idle)) MoveTowards(pickup->GetActorLocation(), 30.f);
+}
+
+void AOmegaBotController::ThinkRoam()
+{
+	const float now = GetWorld()->GetTimeSeconds();
+	const FVector location = Bot->GetActorLocation();
+	const float distance = FVector::Dist2D(location, MoveTarget);
+
+	// back on our feet after a slide
+	if (Bot->bIsCrouching && !Bot->bIsSliding) Bot->StopCrouch();
+
+	if ((now >= StateEndTime) || (distance < 150.f))
+	{
+		StateEndTime = now + GoalTimeout;
+		ClearFocus(EAIFocusPriority::Gameplay);
+
+		FVector target = location + FVector(Random.GetUnitVector().GetSafeNormal2D() * Random.FRandRange(0.25f, 1.f) * RoamRadius);
+		FNavLocation navLocation;
+		UNavigationSystem* navSys = UNavigationSystem::GetCurrent<UNavigationSystem>(GetWorld());
+		if (navSys && navSys->GetRandomReachablePointInRadius(location, RoamRadius, navLocation)) target = navLocation.Location;
+
+		MoveTowards(target, 100.f);
+
+		// a long way to go, run it
+		if ((FVector::Dist2D(location, target) > SprintDistance) && !Bot->bIsSprinting) Bot->DoSprint();
+		return;
+	}
+
+	if (Bot->bIsSprinting)
+	{
+		// nearly there, or drop into a slide on the way
+		if (distance < SprintDistance * 0.25f) Bot->DoSprint();
+		else if (Random.FRand() < SlideChance) Bot->DoCrouch();
+	}
+}
+
+void AOmegaBotController::SetState(EOmegaBotState NewState, AActor* NewGoal)
+{
+	const float now = GetWorld()->GetTimeSeconds();
+
+	State = NewState;
+	Goal = NewGoal;
+	// engaging starts strafing right away, roaming picks a new target right away
+	StateEndTime = (NewState == EOmegaBotState::Engage) ? now : now + GoalTimeout;
+	if (NewState == EOmegaBotState::Roam && Bot) MoveTarget = Bot->GetActorLocation();
+
+	if ((NewState != EOmegaBotState::Engage) && (NewState != EOmegaBotState::TakeCover))
+	{
+		ReleaseTrigger();
+		ClearFocus(EAIFocusPriority::Gameplay);
+	}
+
+	if (NewState != EOmegaBotState::Roam) StopMoving();
+}
+
+void AOmegaBotController::MoveTowards(const FVector& Location, float AcceptanceRadius)
+{
+	MoveTarget = Location;
+
+	// maps without a navmesh still get moving bots, just not around obstacles
+	bSteering = (MoveToLocation(Location, AcceptanceRadius) == EPathFollowingRequestResult::Failed);
+}
+
+void AOmegaBotController::StopMoving()
+{
+	StopMovement();
+	bSteering = false;
+}
+
+void AOmegaBotController::PullTrigger()
+{
+	AOmegaGunBase* weapon = Bot->GetCurrentWeapon();
+	if (bIsTriggerHeld || !weapon || weapon->IsReloading() || (weapon->currentClipAmmo <= 0)) return;
+
+	if (Random.FRand() < SecondaryFireChance)
+	{
+		Bot->OnSecondaryFire();
+		return;
+	}
+
+	// held long enough for auto and burst to run, single fire just takes the one shot
+	Bot->OnPrimaryFire();
+	bIsTriggerHeld = true;
+	TriggerReleaseTime = GetWorld()->GetTimeSeconds() + Random.FRandRange(0.2f, 1.5f);
+}
+
+void AOmegaBotController::ReleaseTrigger()
+{
+	if (bIsTriggerHeld && Bot) Bot->OnPrimaryFireEnd();
+	bIsTriggerHeld = false;
+}
+
+void AOmegaBotController::CycleFireMode()
+{
+	AOmegaGunBase* weapon = Bot->GetCurrentWeapon();
+	if (!weapon || !weapon->HasAuthority()) return;
+
+	ReleaseTrigger();
+
+	// the gun may already be on one of our variants, step on from the archetype it came from
+	const UOmegaWeaponArchetype* current = weapon->GetArchetype();
+	const FFireModeVariant* currentVariant = FireModeVariants.FindByPredicate([current](const FFireModeVariant& Variant) { return Variant.Variant == current; });
+	const UOmegaWeaponArchetype* source = (currentVariant) ? currentVariant->Source : current;
+	const EFireMode nextMode = (EFireMode)(((uint8)weapon->TriggerConfig + 1) % ((uint8)EFireMode::FM_Auto + 1));
+
+	const FFireModeVariant* next = FireModeVariants.FindByPredicate([source, nextMode](const FFireModeVariant& Variant) { return (Variant.Source == source) && (Variant.Mode == nextMode); });
+	if (!next)
+	{
+		UOmegaWeaponArchetype* variant = NewObject<UOmegaWeaponArchetype>(this, source->GetClass(), NAME_None, RF_Transient, const_cast<UOmegaWeaponArchetype*>(source));
+		variant->TriggerConfig = nextMode;
+		FireModeArchetypes.Add(variant);
+		next = &FireModeVariants[FireModeVariants.Add({ source, nextMode, variant })];
+	}
+
+	weapon->SetArchetype(next->Variant);
+}
+
+AOmegaCharacter* AOmegaBotController::FindEnemy() const
+{
+	const FVector origin = Bot->GetActorLocation();
+	const FVector forward = Bot->GetActorForwardVector();
+	const float minDot = FMath::Cos(FMath::DegreesToRadians(SightHalfAngle));
+
+	AOmegaCharacter* nearest = nullptr;
+	float nearestDistanceSq = FMath::Square(SightRange);
+
+	for (TActorIterator<AOmegaCharacter> It(GetWorld()); It; ++It)
+	{
+		AOmegaCharacter* other = *It;
+		if ((other == Bot) || other->IsDead()) continue;
+
+		const FVector toOther = other->GetActorLocation() - origin;
+		const float distanceSq = toOther.SizeSquared();
+		if (distanceSq >= nearestDistanceSq) continue;
+
+		// the current enemy is tracked all the way round, new ones have to be in view
+		if ((other != Enemy) && (FVector::DotProduct(toOther.GetSafeNormal(), forward) < minDot)) continue;
+
+		nearest = other;
+		nearestDistanceSq = distanceSq;
+	}
+
+	if (!nearest) return nullptr;
+
+	INC_DWORD_STAT(STAT_OmegaTracesIssued);
+	return (LineOfSightTo(nearest)) ? nearest : nullptr;
+}
+
+AActor* AOmegaBotController::FindInteractable(TFunctionRef<bool(EViewTargetState)> Filter) const
+{
+	const FVector origin = Bot->GetActorLocation();
+	FOmegaInteractableRegistry& registry = FOmegaInteractableRegistry::Get(GetWorld());
+
+	TArray<AActor*, TInlineAllocator<8>> candidates;
+	registry.QueryCone(origin, Bot->GetActorForwardVector(), SightRange, SightHalfAngle, candidates);
+
+	candidates.Sort([&origin](const AActor& A, const AActor& B)
+	{
+		return FVector::DistSquared(origin, A.GetActorLocation()) < FVector::DistSquared(origin, B.GetActorLocation());
+	});
+
+	// the nearest one that's actually in view - cover or a pickup behind a wall doesn't count, same as for EnterCover and the reticle
+	FCollisionQueryParams params = FCollisionQueryParams(FName(TEXT("collision query")), false, Bot);
+	const FVector eyes = Bot->GetPawnViewLocation();
+
+	for (AActor* candidate : candidates)
+	{
+		if (!Filter(registry.GetReticleTag(candidate))) continue;
+
+		FHitResult hit;
+		INC_DWORD_STAT(STAT_OmegaTracesIssued);
+		if (!GetWorld()->LineTraceSingleByObjectType(hit, eyes, candidate->GetActorLocation(), OmegaObjectQueries::Reticle, params) || (hit.GetActor() == candidate)) return candidate;
+	}
+
+	return nullptr;
+}
@@ -0,0 +1,116 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "OmegaCharacter.h"
+#include "OmegaWeaponArchetype.h"
+#include "OmegaBotController.generated.h"
+
+UENUM()
+enum class EOmegaBotState : uint8
+{
+	Roam,
+	Engage,
+	TakeCover,
+	Collect
+};
+
+/**
+ * Soak-test bot for AOmegaCharacter. Makes the same calls the input bindings do - moves, sprints, slides, takes cover
+ * with EnterCover, fires in every fire mode, reloads, swaps weapons and collects pickups - so a server full of bots
+ * runs the real gameplay paths. Cover and pickups are found through the interactable registry, enemies by sight.
+ */
+UCLASS(config=Game)
+class OMEGA_API AOmegaBotController : public AAIController
+{
+	GENERATED_BODY()
+
+public:
+	AOmegaBotController();
+
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void Possess(APawn* InPawn) override;
+	virtual void UnPossess() override;
+
+protected:
+	/** seconds between decisions, the trigger and movement are still updated every tick */
+	UPROPERTY(Config)
+	float ThinkInterval = 0.25f;
+	UPROPERTY(Config)
+	float SightRange = 3000.f;
+	UPROPERTY(Config)
+	float SightHalfAngle = 60.f;
+	UPROPERTY(Config)
+	float RoamRadius = 2500.f;
+	/** roam targets further than this are sprinted to, and sometimes slid into */
+	UPROPERTY(Config)
+	float SprintDistance = 1000.f;
+	UPROPERTY(Config)
+	float CoverTime = 4.f;
+	/** gives up on a roam, cover or pickup goal it hasn't reached in this long */
+	UPROPERTY(Config)
+	float GoalTimeout = 10.f;
+	/** seconds between switching the gun in hand to its next fire mode */
+	UPROPERTY(Config)
+	float FireModeInterval = 20.f;
+	/** chances per decision */
+	UPROPERTY(Config)
+	float CoverChance = 0.15f;
+	UPROPERTY(Config)
+	float SlideChance = 0.1f;
+	UPROPERTY(Config)
+	float SecondaryFireChance = 0.1f;
+	UPROPERTY(Config)
+	float WeaponSwapChance = 0.02f;
+
+private:
+	void Think();
+	void ThinkEngage();
+	void ThinkTakeCover();
+	void ThinkCollect();
+	void ThinkRoam();
+
+	void SetState(EOmegaBotState NewState, AActor* NewGoal = nullptr);
+	void MoveTowards(const FVector& Location, float AcceptanceRadius);
+	void StopMoving();
+	void PullTrigger();
+	void ReleaseTrigger();
+	void CycleFireMode();
+
+	AOmegaCharacter* FindEnemy() const;
+	/** the nearest registered interactable in view and not behind anything that passes Filter, by its reticle tag */
+	AActor* FindInteractable(TFunctionRef<bool(EViewTargetState)> Filter) const;
+
+	UPROPERTY()
+	AOmegaCharacter* Bot;
+	UPROPERTY()
+	AOmegaCharacter* Enemy;
+	UPROPERTY()
+	AActor* Goal;
+
+	// per-mode copies of each gun's archetype, made once and reused
+	struct FFireModeVariant
+	{
+		const UOmegaWeaponArchetype* Source;
+		EFireMode Mode;
+		UOmegaWeaponArchetype* Variant;
+	};
+	TArray<FFireModeVariant> FireModeVariants;
+	// keeps the variants alive
+	UPROPERTY()
+	TArray<UOmegaWeaponArchetype*> FireModeArchetypes;
+
+	EOmegaBotState State = EOmegaBotState::Roam;
+	FRandomStream Random;
+	FVector MoveTarget = FVector::ZeroVector;
+	// no navmesh to path on, walk straight at MoveTarget instead
+	bool bSteering = false;
+	bool bIsTriggerHeld = false;
+
+	float NextThinkTime = 0.f;
+	float StateEndTime = 0.f;
+	float TriggerReleaseTime = 0.f;
+	float NextFireModeTime = 0.f;
+};
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaBulletManager.h"
+#include "Omega.h"
+#include "OmegaProjectile.h"
+#include "OmegaCharacter.h"
+#include "OmegaDamageQueue.h"
+#include "OmegaTelemetry.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+AOmegaBulletManager::AOmegaBulletManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+AOmegaBulletManager* AOmegaBulletManager::Get(UWorld* World)
+{
+	if (!World) return nullptr;
+
+	for (TActorIterator<AOmegaBulletManager> It(World); It; ++It)
+	{
+		return *It;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AOmegaBulletManager>(SpawnParams);
+}
+
+void AOmegaBulletManager::Fire(TSubclassOf<AOmegaProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* BulletOwner)
+{
+	if (!ProjectileClass) return;
+
+	const AOmegaProjectile* Defaults = ProjectileClass->GetDefaultObject<AOmegaProjectile>();
+	const UProjectileMovementComponent* Movement = Defaults->GetProjectileMovement();
+
+	Positions.Add(Location);
+	PreviousPositions.Add(Location);
+	Velocities.Add(Rotation.Vector() * Movement->InitialSpeed);
+	GravityZ.Add(GetWorld()->GetGravityZ() * Movement->ProjectileGravityScale);
+	LifeRemaining.Add((Defaults->InitialLifeSpan > 0.f) ? Defaults->InitialLifeSpan : 3.f);
+	Radii.Add(Defaults->GetCollisionComp()->GetUnscaledSphereRadius());
+	Damage.Add(Defaults->GetProjectileDamage());
+	Force.Add(Defaults->GetProjectileForce());
+	Owners.Add(BulletOwner);
+	INC_DWORD_STAT(STAT_OmegaProjectilesAlive);
+}
+
+void AOmegaBulletManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (Positions.Num() == 0) return;
+
+	Integrate(DeltaSeconds);
+	ResolveCollisions();
+	RemoveExpired();
+}
+
+void AOmegaBulletManager::Integrate(float DeltaSeconds)
+{
+	const int32 Count = Positions.Num();
+	FVector* RESTRICT Position = Positions.GetData();
+	FVector* RESTRICT PreviousPosition = PreviousPositions.GetData();
+	FVector* RESTRICT Velocity = Velocities.GetData();
+	const float* RESTRICT Gravity = GravityZ.GetData();
+	float* RESTRICT Life = LifeRemaining.GetData();
+
+	// straight-line pass over contiguous arrays, no branches or virtual calls
+	for (int32 i = 0; i < Count; i++)
+	{
+		PreviousPosition[i] = Position[i];
+		Velocity[i].Z += Gravity[i] * DeltaSeconds;
+		Position[i] += Velocity[i] * DeltaSeconds;
+		Life[i] -= DeltaSeconds;
+	}
+}
+
+void AOmegaBulletManager::ResolveCollisions()
+{
+	UWorld* const World = GetWorld();
+	static const FName BulletTraceTag(TEXT("bullet sweep"));
+	const int32 Count = Positions.Num();
+	// bullets a client fired ahead of the server only stop, the server's copies apply the hits
+	const bool bApplyHits = OmegaNet::IsGameplayAuthority(World);
+	AOmegaDamageQueue* const Queue = (bApplyHits) ? AOmegaDamageQueue::Get(World) : nullptr;
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		FCollisionQueryParams params(BulletTraceTag, false, Owners[i].Get());
+		FHitResult hit;
+
+		INC_DWORD_STAT(STAT_OmegaTracesIssued);
+		if (!World->SweepSingleByObjectType(hit, PreviousPositions[i], Positions[i], FQuat::Identity, OmegaObjectQueries::Combat, FCollisionShape::MakeSphere(Radii[i]), params)) continue;
+
+		// anything blocking ends the bullet, physics bodies and characters also take the hit
+		LifeRemaining[i] = 0.f;
+
+		if ((hit.GetActor() == NULL) || (hit.GetComponent() == NULL) || !bApplyHits) continue;
+
+		// simulated bullets don't keep the gun that fired them
+		FOmegaTelemetry::RecordHit(Owners[i].Get(), nullptr, hit.GetActor(), hit.Location);
+
+		if (hit.GetComponent()->IsSimulatingPhysics())
+		{
+			Queue->AddImpulse(hit.GetComponent(), Velocities[i] * Force[i], hit.Location);
+		}
+
+		AOmegaCharacter* omegaActor = Cast<AOmegaCharacter>(hit.GetActor());
+
+		if (omegaActor)
+		{
+			Queue->AddDamage(omegaActor, Damage[i]);
+		}
+	}
+}
+
+void AOmegaBulletManager::RemoveExpired()
+{
+	for (int32 i = Positions.Num() - 1; i >= 0; i--)
+	{
+		if (LifeRemaining[i] <= 0.f) RemoveBullet(i);
+	}
+}
+
+void AOmegaBulletManager::RemoveBullet(int32 Index)
+{
+	Positions.RemoveAtSwap(Index, 1, false);
+	PreviousPositions.RemoveAtSwap(Index, 1, false);
+	Velocities.RemoveAtSwap(Index, 1, false);
+	GravityZ.RemoveAtSwap(Index, 1, false);
+	LifeRemaining.RemoveAtSwap(Index, 1, false);
+	Radii.RemoveAtSwap(Index, 1, false);
+	Damage.RemoveAtSwap(Index, 1, false);
+	Force.RemoveAtSwap(Index, 1, false);
+	Owners.RemoveAtSwap(Index, 1, false);
+	DEC_DWORD_STAT(STAT_OmegaProjectilesAlive);
+}
+
+void AOmegaBulletManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	DEC_DWORD_STAT_BY(STAT_OmegaProjectilesAlive, Positions.Num());
+
+	Super::EndPlay(EndPlayReason);
+}
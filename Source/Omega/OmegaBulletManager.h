@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "OmegaBulletManager.generated.h"
+
+class AOmegaProjectile;
+
+/**
+ * World-level simulation of projectiles without an actor per bullet. Bullet state lives in parallel arrays,
+ * is advanced in one pass per frame and resolved with one swept sphere per bullet, dispatching the same
+ * damage and impulse as AOmegaProjectile::OnHit. Bullets take their tuning from the projectile class defaults.
+ */
+UCLASS()
+class OMEGA_API AOmegaBulletManager : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AOmegaBulletManager();
+
+	/** returns the world's bullet manager, spawning it on first use */
+	static AOmegaBulletManager* Get(UWorld* World);
+
+	/** launches a simulated bullet using the class defaults of ProjectileClass, ignoring BulletOwner when resolving hits */
+	void Fire(TSubclassOf<AOmegaProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* BulletOwner);
+
+	FORCEINLINE int32 GetBulletCount() const { return Positions.Num(); }
+
+protected:
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	void Integrate(float DeltaSeconds);
+	void ResolveCollisions();
+	void RemoveExpired();
+	void RemoveBullet(int32 Index);
+
+	TArray<FVector> Positions;
+	TArray<FVector> PreviousPositions;
+	TArray<FVector> Velocities;
+	TArray<float> GravityZ;
+	TArray<float> LifeRemaining;
+	TArray<float> Radii;
+	TArray<float> Damage;
+	TArray<float> Force;
+	TArray<TWeakObjectPtr<AActor>> Owners;
+};
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OmegaBulletManager.h"
+#include "OmegaCharacter.h"
+#include "OmegaGunBase.h"
+#include "OmegaProjectile.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmegaBulletBudget, Log, All);
+
+namespace
+{
+	const float BudgetMs = 2.f;
+	const float TickSeconds = 1.f / 60.f;
+	// ticks timed at each bullet count, the median is the one compared against the budget
+	const int32 TicksPerStep = 5;
+	// the count grows geometrically so the whole ramp fits inside a bullet's lifetime
+	const int32 FirstStep = 256;
+	const float StepGrowth = 1.25f;
+	const int32 MaxBullets = 200000;
+}
+
+/**
+ * Ramps the number of bullets in a bullet manager of its own until its tick takes longer than BudgetMs. The bullets go
+ * up out of the map from the player's position so none of them hit anything and leave the simulation early.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FOmegaBulletBudgetCommand, FAutomationTestBase*, Test);
+
+bool FOmegaBulletBudgetCommand::Update()
+{
+	AOmegaCharacter* character = OmegaTests::GetPlayerCharacter();
+	if (!character) return true;
+
+	// the player's own bullets if the gun fires any, the native projectile otherwise
+	TSubclassOf<AOmegaProjectile> projectileClass = AOmegaProjectile::StaticClass();
+	if (AOmegaGunBase* weapon = character->GetCurrentWeapon())
+	{
+		if (weapon->GetArchetype()->ProjectileClass) projectileClass = weapon->GetArchetype()->ProjectileClass;
+	}
+
+	// ticked by hand below, the world tick would run it a second time each frame
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	AOmegaBulletManager* manager = character->GetWorld()->SpawnActor<AOmegaBulletManager>(SpawnParams);
+	if (!manager)
+	{
+		Test->AddError(TEXT("couldn't spawn a bullet manager"));
+		return true;
+	}
+	manager->SetActorTickEnabled(false);
+
+	const FVector origin = character->GetPawnViewLocation();
+	FRandomStream random(0x0BE6A);
+
+	int32 fired = 0;
+	int32 withinBudget = 0;
+	float withinBudgetMs = 0.f;
+	float lastMs = 0.f;
+	int32 nextCount = FirstStep;
+
+	while (nextCount <= MaxBullets)
+	{
+		for (; fired < nextCount; fired++)
+		{
+			manager->Fire(projectileClass, origin, FRotator(random.FRandRange(60.f, 90.f), random.FRandRange(0.f, 360.f), 0.f), character);
+		}
+
+		float tickMs[TicksPerStep];
+		for (int32 sample = 0; sample < TicksPerStep; sample++)
+		{
+			const uint32 startCycles = FPlatformTime::Cycles();
+			manager->TickActor(TickSeconds, LEVELTICK_All, manager->PrimaryActorTick);
+			tickMs[sample] = FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - startCycles);
+		}
+		Sort(tickMs, TicksPerStep);
+		lastMs = tickMs[TicksPerStep / 2];
+
+		if (manager->GetBulletCount() < fired)
+		{
+			Test->AddWarning(FString::Printf(TEXT("%d of %d bullets left the simulation early, the ramp stops there"), fired - manager->GetBulletCount(), fired));
+			break;
+		}
+
+		if (lastMs > BudgetMs) break;
+
+		withinBudget = manager->GetBulletCount();
+		withinBudgetMs = lastMs;
+		nextCount = FMath::CeilToInt(nextCount * StepGrowth);
+	}
+
+	manager->Destroy();
+
+	const FString result = (withinBudget == 0)
+		? FString::Printf(TEXT("%s: even %d bullets took %.3f ms, over the %.1f ms budget"), *GetNameSafe(projectileClass), FirstStep, lastMs, BudgetMs)
+		: FString::Printf(TEXT("%s: %d bullets fit in a %.1f ms tick (%.3f ms), %d took %.3f ms"), *GetNameSafe(projectileClass), withinBudget, BudgetMs, withinBudgetMs, fired, lastMs);
+	UE_LOG(LogOmegaBulletBudget, Log, TEXT("%s"), *result);
+	Test->AddInfo(result);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmegaBulletBudgetTest, "Omega.Benchmark.BulletManagerBudget", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FOmegaBulletBudgetTest::RunTest(const FString& Parameters)
+{
+	OmegaAddLoadTestMapCommands(this);
+	ADD_LATENT_AUTOMATION_COMMAND(FOmegaBulletBudgetCommand(this));
+	return true;
+}
+
+#endif
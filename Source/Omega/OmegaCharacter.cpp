@@ -1,6 +1,7 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "OmegaCharacter.h"
+#include "Omega.h"
 #include "OmegaProjectile.h"
 #include "Animation/AnimInstance.h"
 #include "Camera/CameraComponent.h"
@@ -15,16 +16,41 @@
 #include "Components/ChildActorComponent.h"
 #include "Runtime/Engine/Public/TimerManager.h"
 #include "Pickup.h"
+#if WITH_DEV_AUTOMATION_TESTS
 #include "OmegaHealthPickup.h"
 #include "OmegaAmmoPickup.h"
 #include "OmegaObjectivePickup.h"
+#endif
+#include "OmegaInteractableRegistry.h"
+#include "OmegaDamageQueue.h"
+#include "OmegaTelemetry.h"
+#include "Engine/StreamableManager.h"
 
 #include <EngineGlobals.h>
 #include <Runtime/Engine/Classes/Engine/Engine.h>
 #include "DrawDebugHelpers.h"
+#include "Net/UnrealNetwork.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Character Ticks"), STAT_OmegaCharacterTicks, STATGROUP_Omega);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Character Behavior Ticks"), STAT_OmegaBehaviorTicks, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("Character Tick"), STAT_OmegaCharacterTick, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("UpdateReticleState"), STAT_OmegaUpdateReticleState, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("HandleInCover"), STAT_OmegaHandleInCover, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("HandleMovingToCover"), STAT_OmegaHandleMovingToCover, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("ReceiveDamage"), STAT_OmegaReceiveDamage, STATGROUP_Omega);
+
+namespace OmegaStateFlags
+{
+	const uint8 Crouching = 1 << 0;
+	const uint8 Sprinting = 1 << 1;
+	const uint8 Scoped = 1 << 2;
+	const uint8 Sliding = 1 << 3;
+	const int32 CoverShift = 4;
+	const uint8 CoverMask = 0x3 << CoverShift;
+}
+
 //////////////////////////////////////////////////////////////////////////
 // AOmegaCharacter
 
@@ -59,6 +85,99 @@ AOmegaCharacter::AOmegaCharacter()
 	// creating a default child actor component to 'hold' the secondary weapon
 	GunActor_Secondary = CreateDefaultSubobject<UChildActorComponent>(TEXT("GunActorSecondary"));
 	GunActor_Secondary->SetupAttachment(Mesh1P);
+
+	// the guns replicate their own ammo, so the server spawns them and the components replicate the refs
+	GunActor_Primary->SetIsReplicated(true);
+	GunActor_Secondary->SetIsReplicated(true);
+
+	ReticleTraceDelegate.BindUObject(this, &AOmegaCharacter::OnReticleTraceDone);
+
+	InitBehaviorTick(QuickTurnTick, EOmegaCharacterBehavior::QuickTurn);
+	InitBehaviorTick(SlideTick, EOmegaCharacterBehavior::Slide);
+	InitBehaviorTick(CoverTick, EOmegaCharacterBehavior::Cover);
+	InitBehaviorTick(ReticleTick, EOmegaCharacterBehavior::Reticle);
+
+	// the reticle is always on, its interval is set per frame depending on who controls the pawn
+	ReticleTick.bStartWithTickEnabled = true;
+}
+
+void FOmegaBehaviorTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (!Target || Target->IsPendingKillOrUnreachable() || (TickType == LEVELTICK_ViewportsOnly)) return;
+
+	INC_DWORD_STAT(STAT_OmegaBehaviorTicks);
+	if (!Target->TickBehavior(Behavior, DeltaTime)) SetTickFunctionEnable(false);
+}
+
+FString FOmegaBehaviorTickFunction::DiagnosticMessage()
+{
+	return FString::Printf(TEXT("%s[Behavior %d]"), (Target) ? *Target->GetFullName() : TEXT("null"), (int32)Behavior);
+}
+
+void AOmegaCharacter::InitBehaviorTick(FOmegaBehaviorTickFunction& TickFunction, EOmegaCharacterBehavior Behavior)
+{
+	TickFunction.Target = this;
+	TickFunction.Behavior = Behavior;
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = false;
+	TickFunction.TickGroup = TG_PrePhysics;
+}
+
+void AOmegaCharacter::RegisterActorTickFunctions(bool bRegister)
+{
+	Super::RegisterActorTickFunctions(bRegister);
+
+	FOmegaBehaviorTickFunction* behaviorTicks[] = { &QuickTurnTick, &SlideTick, &CoverTick, &ReticleTick };
+
+	for (FOmegaBehaviorTickFunction* tickFunction : behaviorTicks)
+	{
+		if (bRegister)
+		{
+			tickFunction->SetTickFunctionEnable(tickFunction->bStartWithTickEnabled || tickFunction->IsTickFunctionEnabled());
+			tickFunction->RegisterTickFunction(GetLevel());
+
+			// behaviors run ahead of the main tick, which reads the state they leave behind
+			PrimaryActorTick.AddPrerequisite(this, *tickFunction);
+		}
+		else if (tickFunction->IsTickFunctionRegistered())
+		{
+			tickFunction->UnRegisterTickFunction();
+		}
+	}
+}
+
+void AOmegaCharacter::ActivateBehaviorTick(FOmegaBehaviorTickFunction& TickFunction)
+{
+	TickFunction.SetTickFunctionEnable(true);
+}
+
+bool AOmegaCharacter::TickBehavior(EOmegaCharacterBehavior Behavior, float DeltaTime)
+{
+	switch (Behavior)
+	{
+	case EOmegaCharacterBehavior::QuickTurn:
+		if (bDoQuickTurn) ProcessQuickTurnOnTick(DeltaTime);
+		return bDoQuickTurn;
+
+	case EOmegaCharacterBehavior::Slide:
+		if (bIsSliding) HandleSliding(DeltaTime);
+		return bIsSliding;
+
+	case EOmegaCharacterBehavior::Cover:
+		// simulated proxies only get the cover state to display, CoverActor isn't replicated to them
+		if ((Role != ROLE_Authority) && !IsLocallyControlled()) return false;
+
+		if (CoverState == ECoverState::CS_COVER) HandleInCover();
+		else if (CoverState == ECoverState::CS_MOVING) HandleMovingToCover();
+		return CoverState != ECoverState::CS_NONE;
+
+	case EOmegaCharacterBehavior::Reticle:
+		UpdateReticleState();
+		ReticleTick.TickInterval = (IsLocallyControlled()) ? 0.f : RemoteReticleTickInterval;
+		return true;
+	}
+
+	return false;
 }
 
 void AOmegaCharacter::BeginPlay()
@@ -68,15 +187,14 @@ void AOmegaCharacter::BeginPlay()
 
 	//Attach gun mesh component to Skeleton, doing it here because the skeleton is not yet created in the constructor
 	GunActor_Primary->AttachToComponent(Mesh1P, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
-	CurrentWeapon = Cast<AOmegaGunBase>(GunActor_Primary->GetChildActor());
-	CurrentWeapon->SetOwningPlayerRef(this);
 
 	// attach the secondary weapon as well, but hide it for now until a weapon swap occurs
 	GunActor_Secondary->AttachToComponent(Mesh1P, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
-	AOmegaGunBase* tempSecondWeapon = Cast<AOmegaGunBase>(GunActor_Secondary->GetChildActor());
-	if (tempSecondWeapon) tempSecondWeapon->SetOwningPlayerRef(this);
 	GunActor_Secondary->SetVisibility(false, true);
 
+	RequestSecondaryWeaponLoad();
+	RefreshWeaponRefs();
+
 	normalHeight = GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
 	normalSpeed = GetCharacterMovement()->MaxWalkSpeed;
 	normalRadius = GetCapsuleComponent()->GetUnscaledCapsuleRadius();
@@ -86,36 +204,182 @@ void AOmegaCharacter::BeginPlay()
 
 	currentHealth = maxHealth;
 	currentShield = maxShield;
+	UpdateReplicatedVitals();
+	BroadcastVitalsChanges(0.f, 0.f);
 
 	previousPosition = GetActorLocation();
 	previousRotation = GetControlRotation();
 
 	InitialLeanDisplacement = FirstPersonCameraComponent->GetRelativeTransform().GetLocation();
+
+	if (ShouldRecordPoseHistory()) PoseHistory.Init(PoseHistorySize);
+}
+
+bool AOmegaCharacter::ShouldRecordPoseHistory() const
+{
+	// only a server with remote shooters ever rewinds
+	const ENetMode NetMode = GetNetMode();
+	return (NetMode == NM_DedicatedServer) || (NetMode == NM_ListenServer);
+}
+
+void AOmegaCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AOmegaCharacter, ReplicatedVitals);
+	// the owner drives its own movement states, only other clients need them
+	DOREPLIFETIME_CONDITION(AOmegaCharacter, ReplicatedStateFlags, COND_SkipOwner);
+}
+
+void AOmegaCharacter::RefreshWeaponRefs()
+{
+	AOmegaGunBase* primaryWeapon = Cast<AOmegaGunBase>(GunActor_Primary->GetChildActor());
+	AOmegaGunBase* secondaryWeapon = Cast<AOmegaGunBase>(GunActor_Secondary->GetChildActor());
+
+	if (primaryWeapon) primaryWeapon->SetOwningPlayerRef(this);
+	if (secondaryWeapon) secondaryWeapon->SetOwningPlayerRef(this);
+
+	// a streamed-in secondary shows up visible, holster it unless it's already been swapped to
+	if (secondaryWeapon && bAwaitingSecondaryWeapon)
+	{
+		bAwaitingSecondaryWeapon = false;
+		GunActor_Secondary->SetVisibility(!IsWeaponPrimary && !GetWorldTimerManager().IsTimerActive(WeaponSwapTimerHandle), true);
+	}
+
+	SetCurrentWeapon((IsWeaponPrimary) ? primaryWeapon : secondaryWeapon);
+}
+
+void AOmegaCharacter::RequestSecondaryWeaponLoad()
+{
+	if (SecondaryWeaponClass.IsNull() || GunActor_Secondary->GetChildActor()) return;
+
+	bAwaitingSecondaryWeapon = true;
+	SecondaryWeaponLoadHandle = OmegaAssets::GetStreamableManager().RequestAsyncLoad(SecondaryWeaponClass.ToStringReference(),
+		FStreamableDelegate::CreateUObject(this, &AOmegaCharacter::OnSecondaryWeaponLoaded), FStreamableManager::DefaultAsyncLoadPriority);
+}
+
+void AOmegaCharacter::OnSecondaryWeaponLoaded()
+{
+	// clients only needed the class resident, the gun itself replicates in and is picked up by RefreshWeaponRefs
+	UClass* weaponClass = SecondaryWeaponClass.Get();
+	if (IsPendingKillPending()) return;
+
+	// the class failed to load, there's no secondary to wait for - a swap already under way goes back to the primary
+	if (!weaponClass)
+	{
+		bAwaitingSecondaryWeapon = false;
+		if (!IsWeaponPrimary)
+		{
+			GetWorldTimerManager().ClearTimer(WeaponSwapTimerHandle);
+			IsWeaponPrimary = true;
+			GunActor_Primary->SetVisibility(true, true);
+			RefreshWeaponRefs();
+		}
+		return;
+	}
+	if (!HasAuthority()) return;
+
+	GunActor_Secondary->SetChildActorClass(weaponClass);
+	RefreshWeaponRefs();
+}
+
+void AOmegaCharacter::SetCurrentWeapon(AOmegaGunBase* NewWeapon)
+{
+	if (NewWeapon == CurrentWeapon) return;
+
+	CurrentWeapon = NewWeapon;
+	OnCurrentWeaponChanged.Broadcast(CurrentWeapon);
+}
+
+void AOmegaCharacter::UpdateReplicatedVitals()
+{
+	if (!HasAuthority()) return;
+
+	// anything alive keeps at least one step so it never reads as dead on clients
+	auto Quantize = [](float Current, float Max) -> uint8
+	{
+		if (Current <= 0.f || Max <= 0.f) return 0;
+		return (uint8)FMath::Clamp(FMath::RoundToInt(Current / Max * 255.f), 1, 255);
+	};
+
+	FOmegaQuantizedVitals vitals;
+	vitals.Health = Quantize(currentHealth, maxHealth);
+	vitals.Shield = Quantize(currentShield, maxShield);
+
+	if (vitals != ReplicatedVitals) ReplicatedVitals = vitals;
+}
+
+void AOmegaCharacter::OnRep_Vitals()
+{
+	const float previousHealth = currentHealth;
+	const float previousShield = currentShield;
+	currentHealth = ReplicatedVitals.Health / 255.f * maxHealth;
+	currentShield = ReplicatedVitals.Shield / 255.f * maxShield;
+	BroadcastVitalsChanges(previousHealth, previousShield);
+}
+
+uint8 AOmegaCharacter::PackStateFlags() const
+{
+	uint8 flags = 0;
+	if (bIsCrouching) flags |= OmegaStateFlags::Crouching;
+	if (bIsSprinting) flags |= OmegaStateFlags::Sprinting;
+	if (bIsScoped) flags |= OmegaStateFlags::Scoped;
+	if (bIsSliding) flags |= OmegaStateFlags::Sliding;
+	flags |= ((uint8)CoverState << OmegaStateFlags::CoverShift) & OmegaStateFlags::CoverMask;
+	return flags;
+}
+
+void AOmegaCharacter::OnRep_StateFlags()
+{
+	bIsCrouching = (ReplicatedStateFlags & OmegaStateFlags::Crouching) != 0;
+	bIsSprinting = (ReplicatedStateFlags & OmegaStateFlags::Sprinting) != 0;
+	bIsScoped = (ReplicatedStateFlags & OmegaStateFlags::Scoped) != 0;
+	bIsSliding = (ReplicatedStateFlags & OmegaStateFlags::Sliding) != 0;
+	CoverState = (ECoverState)((ReplicatedStateFlags & OmegaStateFlags::CoverMask) >> OmegaStateFlags::CoverShift);
+}
+
+bool AOmegaCharacter::ServerSetStateFlags_Validate(uint8 Flags)
+{
+	return ((Flags & OmegaStateFlags::CoverMask) >> OmegaStateFlags::CoverShift) <= (uint8)ECoverState::CS_COVER;
+}
+
+void AOmegaCharacter::ServerSetStateFlags_Implementation(uint8 Flags)
+{
+	ReplicatedStateFlags = Flags;
 }
 
 void AOmegaCharacter::Tick(float DeltaSeconds)
 {
+	SCOPE_CYCLE_COUNTER(STAT_OmegaCharacterTick);
 	Super::Tick(DeltaSeconds);
 
-	if (bDoQuickTurn) ProcessQuickTurnOnTick(DeltaSeconds);
-	if (bIsSliding) HandleSliding(DeltaSeconds);
+	INC_DWORD_STAT(STAT_OmegaCharacterTicks);
 
-	UpdateReticleState();
+	// on clients a streamed-in secondary replicates in some time after its class has loaded
+	if (!CurrentWeapon || (bAwaitingSecondaryWeapon && !HasAuthority())) RefreshWeaponRefs();
+	if (CurrentWeapon) CurrentWeapon->RefreshAmmoState();
 
-	FVector positionDelta = GetActorLocation() - previousPosition;
-	if (!positionDelta.IsNearlyZero())
+	// the state flags only go out when one of them actually changed
+	if (IsLocallyControlled())
 	{
-		RechargeShield(shieldRechargeFactor * DeltaSeconds * positionDelta.Size());
-		previousPosition = GetActorLocation();
+		const uint8 stateFlags = PackStateFlags();
+		if (stateFlags != ReplicatedStateFlags)
+		{
+			ReplicatedStateFlags = stateFlags;
+			if (!HasAuthority()) ServerSetStateFlags(stateFlags);
+		}
 	}
 
-	if (CoverState == ECoverState::CS_COVER) HandleInCover();
-	else if (CoverState == ECoverState::CS_MOVING) HandleMovingToCover();
+	if (ShouldRecordPoseHistory())
+	{
+		PoseHistory.Record(GetWorld()->GetTimeSeconds(), GetActorLocation(), GetCapsuleComponent()->GetScaledCapsuleHalfHeight(), GetCapsuleComponent()->GetScaledCapsuleRadius());
+	}
 
-	if (!bIsScoped) 
+	FVector positionDelta = GetActorLocation() - previousPosition;
+	if (!positionDelta.IsNearlyZero())
 	{
-		// TODO: make this behavior lerp over time, set 'target' location in "Unscope"
-		FirstPersonCameraComponent->SetRelativeLocation(InitialLeanDisplacement);
+		RechargeShield(shieldRechargeFactor * DeltaSeconds * positionDelta.Size());
+		previousPosition = GetActorLocation();
 	}
 }
 
@@ -124,6 +388,7 @@ void AOmegaCharacter::DoCrouch()
 	if (bIsSprinting)
 	{
 		bIsSliding = true;
+		ActivateBehaviorTick(SlideTick);
 		SlideDirection = UKismetMathLibrary::GetForwardVector(GetControlRotation());
 		SlideSpeed = GetCharacterMovement()->Velocity.Size();
 		DoSprint();
@@ -163,6 +428,7 @@ void AOmegaCharacter::DoQuickTurn()
 
 	bDoQuickTurn = true;
 	quickTurnDelta = fQuickTurnAngle;
+	ActivateBehaviorTick(QuickTurnTick);
 }
 
 void AOmegaCharacter::ZoomIn()
@@ -181,6 +447,10 @@ void AOmegaCharacter::ZoomIn()
 
 	bIsScoped = !bIsScoped;
 
+	// leaning only happens scoped, so unscoping is when the camera goes back
+	// TODO: make this behavior lerp over time
+	if (!bIsScoped) FirstPersonCameraComponent->SetRelativeLocation(InitialLeanDisplacement);
+
 	FirstPersonCameraComponent->SetFieldOfView(originalFieldOfView * ((bIsScoped) ? scopeZoomFactor : 1.f));
 	GetCharacterMovement()->MaxWalkSpeed = normalSpeed * ((bIsScoped) ? scopeSpeedFactor : 1.f);
 
@@ -196,67 +466,127 @@ void AOmegaCharacter::ResetAim()
 {
 	APlayerController* currentPlayerController = UGameplayStatics::GetPlayerController(this, 0);
 	FRotator currentRotation = currentPlayerController->GetControlRotation();
-	currentPlayerController->SetControlRotation(*(new FRotator(0.f, currentRotation.Yaw, currentRotation.Roll)));
+	currentPlayerController->SetControlRotation(FRotator(0.f, currentRotation.Yaw, currentRotation.Roll));
 }
 
 void AOmegaCharacter::UpdateReticleState()
 {
-	FHitResult* hit = new FHitResult();
+	SCOPE_CYCLE_COUNTER(STAT_OmegaUpdateReticleState);
+
 	FCollisionQueryParams params = FCollisionQueryParams(FName(TEXT("collision query")), false, this);
 	FVector CamLoc = FirstPersonCameraComponent->GetComponentTransform().GetLocation();
-	FRotator CamRot = GetControlRotation();
+	FVector TraceEnd = CamLoc + GetControlRotation().Vector() * MaxAimDistance;
 
-	OverlappedPickupRef = (IsOverlappingPickup) ? OverlappedPickupRef : nullptr;
-	ReticleState = (IsOverlappingPickup) ? ReticleState : EViewTargetState::VTS_DEFAULT;
-	aimLocation = CamLoc + CamRot.Vector() * MaxAimDistance;
+	if (bAsyncReticleTrace && !(bIsScoped && bSyncReticleWhileScoped))
+	{
+		// use last frame's result and queue this frame's trace so it overlaps with the rest of the frame
+		const bool bHasLastResult = ReticleTraceResults[ReticleReadIndex].bValid;
+		if (bHasLastResult)
+		{
+			const FReticleTraceResult& lastResult = ReticleTraceResults[ReticleReadIndex];
+			ResolveReticleState((lastResult.bHit) ? &lastResult.Hit : nullptr, lastResult.TraceEnd);
+		}
 
-	bool bHitSuccess = GetWorld()->LineTraceSingleByObjectType(*hit, CamLoc, CamLoc + CamRot.Vector() * CoverInteractDistance, FCollisionObjectQueryParams::AllObjects, params);
+		INC_DWORD_STAT(STAT_OmegaTracesIssued);
+		ReticleTraceHandle = GetWorld()->AsyncLineTraceByObjectType(EAsyncTraceType::Single, CamLoc, TraceEnd, OmegaObjectQueries::Reticle, params, &ReticleTraceDelegate);
 
-	if (bHitSuccess)
+		// nothing to consume on the first async frame, resolve synchronously below
+		if (bHasLastResult) return;
+	}
+	else if (ReticleTraceHandle.IsValid())
 	{
-		ACoverActorBase* coverActor = Cast<ACoverActorBase>(hit->GetActor());
+		// dropping back to sync, make sure nothing stale gets consumed when async resumes
+		ReticleTraceHandle.Invalidate();
+		ReticleTraceResults[0].bValid = false;
+		ReticleTraceResults[1].bValid = false;
+	}
+
+	// one trace out to the max aim distance - every interact distance is measured along the same camera ray,
+	// so the closest hit is the one the shorter cover/pickup/NPC traces would have found as well
+	FHitResult hit;
+	INC_DWORD_STAT(STAT_OmegaTracesIssued);
+	bool bHitSuccess = GetWorld()->LineTraceSingleByObjectType(hit, CamLoc, TraceEnd, OmegaObjectQueries::Reticle, params);
+
+	ResolveReticleState((bHitSuccess) ? &hit : nullptr, TraceEnd);
+}
+
+void AOmegaCharacter::OnReticleTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceData)
+{
+	// only the most recently queued trace is of interest
+	if (!(TraceHandle == ReticleTraceHandle)) return;
+
+	FReticleTraceResult& backResult = ReticleTraceResults[1 - ReticleReadIndex];
+	backResult.bHit = TraceData.OutHits.Num() > 0;
+	if (backResult.bHit) backResult.Hit = TraceData.OutHits[0];
+	backResult.TraceEnd = TraceData.End;
+	backResult.bValid = true;
+
+	ReticleReadIndex = 1 - ReticleReadIndex;
+}
+
+void AOmegaCharacter::ResolveReticleState(const FHitResult* Hit, const FVector& TraceEnd)
+{
+	OverlappedPickupRef = (IsOverlappingPickup) ? OverlappedPickupRef : nullptr;
+	EViewTargetState newState = EViewTargetState::VTS_DEFAULT;
 
-		if (coverActor)
+	// nothing along the camera ray, aim at the far end of it
+	if (!Hit)
+	{
+		aimLocation = TraceEnd;
+	}
+	else
+	{
+		aimLocation = Hit->Location;
+
+		// interactables carry their reticle state in the registry, anything else leaves the reticle as is
+		const EViewTargetState hitTag = (Hit->Distance <= CoverInteractDistance) ? FOmegaInteractableRegistry::Get(GetWorld()).GetReticleTag(Hit->GetActor()) : EViewTargetState::VTS_DEFAULT;
+
+		if (hitTag == EViewTargetState::VTS_COVER)
 		{
-			ReticleState = (IsOverlappingPickup) ? ReticleState : EViewTargetState::VTS_COVER;
-			aimLocation = hit->Location;
+			newState = EViewTargetState::VTS_COVER;
 		}
-		else
+		else if ((hitTag != EViewTargetState::VTS_DEFAULT) && (Hit->Distance <= PickupInteractDistance))
 		{
-			bHitSuccess = GetWorld()->LineTraceSingleByObjectType(*hit, CamLoc, CamLoc + CamRot.Vector() * PickupInteractDistance, FCollisionObjectQueryParams::AllObjects, params);
+			OverlappedPickupRef = Cast<APickup>(Hit->GetActor());
+			newState = hitTag;
+		}
+	}
 
-			if (bHitSuccess)
-			{
-				APickup* pickupActor = Cast<APickup, AActor>(hit->GetActor());
+	// an overlapped pickup keeps the reticle until the overlap ends
+	if (!IsOverlappingPickup) SetReticleState(newState);
 
-				if (pickupActor)
-				{
-					OverlappedPickupRef = pickupActor;
+	// TODO: NPC reticle within NPCInteractDistance (VTS_NPC), differentiate between talk and stealth attack reticle behavior
+	// potentially dot product of both actors forward vectors - if positive (facing away), stealth; if negative (facing), talk
+	// EViewTargetState::VTS_STEALTH
+}
 
-					if (Cast<AOmegaHealthPickup, APickup>(pickupActor)) ReticleState = (IsOverlappingPickup) ? ReticleState : EViewTargetState::VTS_HEALTH;
-					else if (Cast<AOmegaAmmoPickup, APickup>(pickupActor)) ReticleState = (IsOverlappingPickup) ? ReticleState : EViewTargetState::VTS_AMMO;
-					else if (Cast<AOmegaObjectivePickup, APickup>(pickupActor)) ReticleState = (IsOverlappingPickup) ? ReticleState : EViewTargetState::VTS_OBJECT;
-				}
-			}
+#if WITH_DEV_AUTOMATION_TESTS
+void AOmegaCharacter::ResolveReticleStateLegacy(const FVector& CamLoc, const FVector& Direction, EViewTargetState& OutState, FVector& OutAimLocation) const
+{
+	FHitResult hit;
+	FCollisionQueryParams params = FCollisionQueryParams(FName(TEXT("collision query")), false, this);
 
-			if (false)
-			{
-				if (GetWorld()->LineTraceSingleByObjectType(*hit, CamLoc, CamLoc + CamRot.Vector() * NPCInteractDistance, FCollisionObjectQueryParams::AllObjects, params))
-				{
-					ReticleState = (IsOverlappingPickup) ? ReticleState : EViewTargetState::VTS_NPC;
-					aimLocation = hit->Location;
-					// TODO: differentiate between talk and stealth attack reticle behavior
-					// potentially dot product of both actors forward vectors - if positive (facing away), stealth; if negative (facing), talk
-					// EViewTargetState::VTS_STEALTH
-				}
-			}
-		}
-	}
+	OutState = EViewTargetState::VTS_DEFAULT;
+	OutAimLocation = CamLoc + Direction * MaxAimDistance;
+
+	if (GetWorld()->LineTraceSingleByObjectType(hit, CamLoc, CamLoc + Direction * CoverInteractDistance, OmegaObjectQueries::Reticle, params))
 	{
-		// nothing closer than CoverInteractDistance but want to set aim location based on trace up to max distance
-		if (GetWorld()->LineTraceSingleByObjectType(*hit, CamLoc, CamLoc + CamRot.Vector() * MaxAimDistance, FCollisionObjectQueryParams::AllObjects, params)) aimLocation = hit->Location;
+		if (Cast<ACoverActorBase>(hit.GetActor()))
+		{
+			OutState = EViewTargetState::VTS_COVER;
+		}
+		else if (GetWorld()->LineTraceSingleByObjectType(hit, CamLoc, CamLoc + Direction * PickupInteractDistance, OmegaObjectQueries::Reticle, params))
+		{
+			if (Cast<AOmegaHealthPickup>(hit.GetActor())) OutState = EViewTargetState::VTS_HEALTH;
+			else if (Cast<AOmegaAmmoPickup>(hit.GetActor())) OutState = EViewTargetState::VTS_AMMO;
+			else if (Cast<AOmegaObjectivePickup>(hit.GetActor())) OutState = EViewTargetState::VTS_OBJECT;
+		}
 	}
+
+	// nothing closer than CoverInteractDistance but want to set aim location based on trace up to max distance
+	if (GetWorld()->LineTraceSingleByObjectType(hit, CamLoc, CamLoc + Direction * MaxAimDistance, OmegaObjectQueries::Reticle, params)) OutAimLocation = hit.Location;
 }
+#endif
 
 void AOmegaCharacter::Action()
 {
@@ -296,6 +626,8 @@ void AOmegaCharacter::HandleSliding(float DeltaTime)
 
 void AOmegaCharacter::HandleMovingToCover()
 {
+	SCOPE_CYCLE_COUNTER(STAT_OmegaHandleMovingToCover);
+
 	FVector DeltaPosition = coverEntryLocation - GetActorLocation();
 	float DotX = UKismetMathLibrary::Dot_VectorVector(GetActorForwardVector(), DeltaPosition.GetSafeNormal());
 	float DotY = UKismetMathLibrary::Dot_VectorVector(GetActorRightVector(), DeltaPosition.GetSafeNormal());
@@ -313,25 +645,33 @@ void AOmegaCharacter::EnterCover()
 {
 	GetCapsuleComponent()->SetCapsuleRadius(coverRadiusFactor * normalRadius);
 
-	FHitResult* hit = new FHitResult();
+	FHitResult hit;
 	FCollisionQueryParams params = FCollisionQueryParams(FName(TEXT("collision query")), false, this);
 	FVector StartLoc = GetActorLocation();
 	FVector StartRot = GetActorForwardVector();
 
-	if (GetWorld()->LineTraceSingleByObjectType(*hit, StartLoc, StartLoc + StartRot * CoverInteractDistance, FCollisionObjectQueryParams::AllObjects, params))
+	INC_DWORD_STAT(STAT_OmegaTracesIssued);
+	if (GetWorld()->LineTraceSingleByObjectType(hit, StartLoc, StartLoc + StartRot * CoverInteractDistance, OmegaObjectQueries::Cover, params))
 	{
-		if (hit->GetActor() == CoverActor) return;
+		if (hit.GetActor() == CoverActor) return;
 
-		CoverActor = Cast<ACoverActorBase>(hit->GetActor());
-		CoverNormalVector = hit->Normal;
+		CoverActor = Cast<ACoverActorBase>(hit.GetActor());
+		if (!CoverActor)
+		{
+			ExitCover();
+			return;
+		}
+
+		CoverNormalVector = hit.Normal;
 		bool bIsShortCover = CoverActor->GetIsCrouchHeight();
 
 		if ((!bIsShortCover && bIsCrouching) || (bIsShortCover && !bIsCrouching)) DoCrouch();	
 
-		coverEntryLocation = hit->Location;
+		coverEntryLocation = hit.Location;
 		coverEntryLocation += CoverNormalVector * (GetCapsuleComponent()->GetUnscaledCapsuleRadius());
 
 		CoverState = ECoverState::CS_MOVING;
+		ActivateBehaviorTick(CoverTick);
 	}
 	else
 	{
@@ -351,6 +691,14 @@ void AOmegaCharacter::ExitCover()
 
 void AOmegaCharacter::HandleInCover()
 {
+	SCOPE_CYCLE_COUNTER(STAT_OmegaHandleInCover);
+
+	if (!CoverActor)
+	{
+		ExitCover();
+		return;
+	}
+
 	FVector PlayerLoc = GetActorLocation();
 	FVector CoverActorLoc = CoverActor->GetActorLocation();
 	float CapsuleRad = GetCapsuleComponent()->GetUnscaledCapsuleRadius() + CoverActorGap;
@@ -367,10 +715,13 @@ void AOmegaCharacter::HandleInCover()
 
 	SetActorLocation(PlayerLoc);
 
-	FHitResult* hit = new FHitResult();
+	FHitResult hit;
 	FCollisionQueryParams params = FCollisionQueryParams(FName(TEXT("collision query")), false, this);
 
-	if (!GetWorld()->LineTraceSingleByObjectType(*hit, GetActorLocation(), GetActorLocation() + CoverNormalVector * fMinCoverDistance, FCollisionObjectQueryParams::AllObjects, params) ||
+	// still backed onto the same cover, and not onto a wall in front of it
+	INC_DWORD_STAT(STAT_OmegaTracesIssued);
+	if (!GetWorld()->LineTraceSingleByObjectType(hit, GetActorLocation(), GetActorLocation() + CoverNormalVector * fMinCoverDistance, OmegaObjectQueries::Cover, params) ||
+		!Cast<ACoverActorBase>(hit.GetActor()) ||
 		(UKismetMathLibrary::Dot_VectorVector(GetCharacterMovement()->GetLastInputVector(), CoverNormalVector) > CoverExitThresholdFactor))
 	{
 		ExitCover();
@@ -379,14 +730,17 @@ void AOmegaCharacter::HandleInCover()
 
 void AOmegaCharacter::StartWeaponSwap()
 {
-	if (GetWorldTimerManager().IsTimerActive(CurrentWeapon->GetPrimaryFireTimerHandle())) return;
-	if (!GunActor_Secondary->GetChildActor()) return;
+	if (!CurrentWeapon || CurrentWeapon->IsFireCycleActive()) return;
+	// the holstered weapon may still be streaming in, the swap time covers for it
+	if (!GunActor_Secondary->GetChildActor() && !bAwaitingSecondaryWeapon) return;
 
 	if (IsWeaponPrimary) GunActor_Primary->SetVisibility(false, true);
 	else GunActor_Secondary->SetVisibility(false, true);
 
 	IsWeaponPrimary = !IsWeaponPrimary;
 
+	INC_DWORD_STAT(STAT_OmegaTimersArmed);
+	OmegaStats::TimersArmed++;
 	GetWorldTimerManager().SetTimer(WeaponSwapTimerHandle, this, &AOmegaCharacter::FinishWeaponSwap, WeaponSwapTime);
 }
 
@@ -406,7 +760,7 @@ void AOmegaCharacter::FinishWeaponSwap()
 		newWeapon = Cast<AOmegaGunBase>(GunActor_Secondary->GetChildActor());
 	}
 
-	CurrentWeapon = newWeapon;
+	SetCurrentWeapon(newWeapon);
 }
 
 void AOmegaCharacter::ProcessQuickTurnOnTick(float DeltaTime)
@@ -436,49 +790,58 @@ void AOmegaCharacter::StartReload()
 	}
 }
 
-void AOmegaCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
+const TArray<FOmegaActionInput>& AOmegaCharacter::GetActionInputs()
 {
-	// set up gameplay key bindings
-	check(PlayerInputComponent);
-
-	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ACharacter::Jump);
-	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
-
-	PlayerInputComponent->BindAction("PrimaryFire", IE_Pressed, this, &AOmegaCharacter::OnPrimaryFire);
-	PlayerInputComponent->BindAction("PrimaryFire", IE_Released, this, &AOmegaCharacter::OnPrimaryFireEnd);
-	PlayerInputComponent->BindAction("SecondaryFire", IE_Pressed, this, &AOmegaCharacter::OnSecondaryFire);
-
-	PlayerInputComponent->BindAxis("MoveForward", this, &AOmegaCharacter::MoveForward);
-	PlayerInputComponent->BindAxis("MoveRight", this, &AOmegaCharacter::MoveRight);
+	static const TArray<FOmegaActionInput> Inputs =
+	{
+		{ TEXT("Jump"), &ACharacter::Jump, &ACharacter::StopJumping },
+		{ TEXT("PrimaryFire"), &AOmegaCharacter::OnPrimaryFire, &AOmegaCharacter::OnPrimaryFireEnd },
+		{ TEXT("SecondaryFire"), &AOmegaCharacter::OnSecondaryFire, nullptr },
+		{ TEXT("Crouch"), &AOmegaCharacter::DoCrouch, &AOmegaCharacter::StopCrouch },
+		{ TEXT("Action"), &AOmegaCharacter::Action, &AOmegaCharacter::StopSprint },
+		{ TEXT("QuickTurn"), &AOmegaCharacter::DoQuickTurn, nullptr },
+		{ TEXT("Special"), &AOmegaCharacter::OnSpecial, nullptr },
+		{ TEXT("Scope"), &AOmegaCharacter::ZoomIn, &AOmegaCharacter::ZoomOut },
+		{ TEXT("ResetAim"), &AOmegaCharacter::ResetAim, nullptr },
+		{ TEXT("Reload"), &AOmegaCharacter::StartReload, nullptr },
+		{ TEXT("Melee"), &AOmegaCharacter::OnMelee, nullptr },
+		{ TEXT("ChangeWeapon"), &AOmegaCharacter::StartWeaponSwap, nullptr }
+	};
+	return Inputs;
+}
 
+const TArray<FOmegaAxisInput>& AOmegaCharacter::GetAxisInputs()
+{
 	// We have 2 versions of the rotation bindings to handle different kinds of devices differently
 	// "turn" handles devices that provide an absolute delta, such as a mouse.
 	// "turnrate" is for devices that we choose to treat as a rate of change, such as an analog joystick
-	PlayerInputComponent->BindAxis("Turn", this, &AOmegaCharacter::TurnAbsolute);
-	PlayerInputComponent->BindAxis("TurnRate", this, &AOmegaCharacter::TurnAtRate);
-	PlayerInputComponent->BindAxis("LookUp", this, &AOmegaCharacter::LookUpAbsolute);
-	PlayerInputComponent->BindAxis("LookUpRate", this, &AOmegaCharacter::LookUpAtRate);
-
-	PlayerInputComponent->BindAction("Crouch", IE_Pressed, this, &AOmegaCharacter::DoCrouch);
-	PlayerInputComponent->BindAction("Crouch", IE_Released, this, &AOmegaCharacter::StopCrouch);
-
-	PlayerInputComponent->BindAction("Action", IE_Pressed, this, &AOmegaCharacter::Action);
-	PlayerInputComponent->BindAction("Action", IE_Released, this, &AOmegaCharacter::StopSprint);
-
-	PlayerInputComponent->BindAction("QuickTurn", IE_Pressed, this, &AOmegaCharacter::DoQuickTurn);
-
-	PlayerInputComponent->BindAction("Special", IE_Pressed, this, &AOmegaCharacter::OnSpecial);
-
-	PlayerInputComponent->BindAction("Scope", IE_Pressed, this, &AOmegaCharacter::ZoomIn);
-	PlayerInputComponent->BindAction("Scope", IE_Released, this, &AOmegaCharacter::ZoomOut);
-
-	PlayerInputComponent->BindAction("ResetAim", IE_Pressed, this, &AOmegaCharacter::ResetAim);
+	static const TArray<FOmegaAxisInput> Inputs =
+	{
+		{ TEXT("MoveForward"), &AOmegaCharacter::MoveForward },
+		{ TEXT("MoveRight"), &AOmegaCharacter::MoveRight },
+		{ TEXT("Turn"), &AOmegaCharacter::TurnAbsolute },
+		{ TEXT("TurnRate"), &AOmegaCharacter::TurnAtRate },
+		{ TEXT("LookUp"), &AOmegaCharacter::LookUpAbsolute },
+		{ TEXT("LookUpRate"), &AOmegaCharacter::LookUpAtRate }
+	};
+	return Inputs;
+}
 
-	PlayerInputComponent->BindAction("Reload", IE_Pressed, this, &AOmegaCharacter::StartReload);
+void AOmegaCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent)
+{
+	// set up gameplay key bindings
+	check(PlayerInputComponent);
 
-	PlayerInputComponent->BindAction("Melee", IE_Pressed, this, &AOmegaCharacter::OnMelee);
+	for (const FOmegaActionInput& input : GetActionInputs())
+	{
+		if (input.Pressed) PlayerInputComponent->BindAction(input.Name, IE_Pressed, this, input.Pressed);
+		if (input.Released) PlayerInputComponent->BindAction(input.Name, IE_Released, this, input.Released);
+	}
 
-	PlayerInputComponent->BindAction("ChangeWeapon", IE_Pressed, this, &AOmegaCharacter::StartWeaponSwap);
+	for (const FOmegaAxisInput& input : GetAxisInputs())
+	{
+		PlayerInputComponent->BindAxis(input.Name, this, input.Handler);
+	}
 }
 
 void AOmegaCharacter::SetOverlappingReticle(APickup* OverlappedPickup)
@@ -486,9 +849,7 @@ void AOmegaCharacter::SetOverlappingReticle(APickup* OverlappedPickup)
 	IsOverlappingPickup = true;
 	OverlappedPickupRef = OverlappedPickup;
 	
-	if (Cast<AOmegaHealthPickup, APickup>(OverlappedPickupRef)) ReticleState = EViewTargetState::VTS_HEALTH; 
-	else if (Cast<AOmegaAmmoPickup, APickup>(OverlappedPickupRef)) ReticleState = EViewTargetState::VTS_AMMO;
-	else if (Cast<AOmegaObjectivePickup, APickup>(OverlappedPickupRef)) ReticleState = EViewTargetState::VTS_OBJECT;
+	if (OverlappedPickupRef && OverlappedPickupRef->GetReticleTag() != EViewTargetState::VTS_DEFAULT) SetReticleState(OverlappedPickupRef->GetReticleTag());
 }
 
 void AOmegaCharacter::ClearOverlappingReticle()
@@ -497,8 +858,26 @@ void AOmegaCharacter::ClearOverlappingReticle()
 	OverlappedPickupRef = nullptr;
 }
 
+void AOmegaCharacter::SetReticleState(EViewTargetState NewState)
+{
+	if (NewState == ReticleState) return;
+
+	ReticleState = NewState;
+	OnReticleStateChanged.Broadcast(ReticleState);
+}
+
+void AOmegaCharacter::BroadcastVitalsChanges(float PreviousHealth, float PreviousShield)
+{
+	if (currentHealth != PreviousHealth) OnHealthChanged.Broadcast(currentHealth, maxHealth);
+	if (currentShield != PreviousShield) OnShieldChanged.Broadcast(currentShield, maxShield);
+}
+
 void AOmegaCharacter::ReceiveDamage(float damage)
 {
+	SCOPE_CYCLE_COUNTER(STAT_OmegaReceiveDamage);
+
+	const float previousHealth = currentHealth;
+	const float previousShield = currentShield;
 	float remainingDamage = 0.f;
 	float overkill = 0.f;
 
@@ -523,16 +902,26 @@ void AOmegaCharacter::ReceiveDamage(float damage)
 		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Black, TEXT("You died..."));
 		DisableInput(UGameplayStatics::GetPlayerController(this, 0));
 	}
+
+	UpdateReplicatedVitals();
+	BroadcastVitalsChanges(previousHealth, previousShield);
+	FOmegaTelemetry::RecordDamage(this, previousHealth - currentHealth, previousShield - currentShield);
 }
 
 void AOmegaCharacter::RechargeShield(float regen)
 {
+	const float previousShield = currentShield;
 	currentShield = FMath::Min(maxShield, currentShield + regen);
+	UpdateReplicatedVitals();
+	BroadcastVitalsChanges(currentHealth, previousShield);
 }
 
 void AOmegaCharacter::RegainHealth(float health)
 {
+	const float previousHealth = currentHealth;
 	currentHealth = FMath::Min(maxHealth, currentHealth + health);
+	UpdateReplicatedVitals();
+	BroadcastVitalsChanges(previousHealth, currentShield);
 }
 
 FVector AOmegaCharacter::GetAimLocation()
@@ -542,7 +931,11 @@ FVector AOmegaCharacter::GetAimLocation()
 
 void AOmegaCharacter::RegainAmmo(int32 ammo)
 {
-	if (CurrentWeapon) CurrentWeapon->currentGunAmmo += ammo; 
+	if (CurrentWeapon)
+	{
+		CurrentWeapon->currentGunAmmo += ammo;
+		CurrentWeapon->NotifyAmmoChanged();
+	}
 }
 
 void AOmegaCharacter::OnPrimaryFire()
@@ -619,30 +1012,33 @@ void AOmegaCharacter::OnSecondaryFire()
 
 void AOmegaCharacter::OnMelee()
 {
-	FHitResult* hit = new FHitResult();
+	FHitResult hit;
 	FCollisionQueryParams params = FCollisionQueryParams(FName(TEXT("collision query")), false, this);
 	FVector CamLoc;
 	FRotator CamRot;
 	GetActorEyesViewPoint(CamLoc, CamRot);
 
-	bool bHitSuccess = GetWorld()->LineTraceSingleByObjectType(*hit, CamLoc, CamLoc + CamRot.Vector() * NPCInteractDistance, FCollisionObjectQueryParams::AllObjects, params);
+	INC_DWORD_STAT(STAT_OmegaTracesIssued);
+	bool bHitSuccess = GetWorld()->LineTraceSingleByObjectType(hit, CamLoc, CamLoc + CamRot.Vector() * NPCInteractDistance, OmegaObjectQueries::Combat, params);
 
 	if (bHitSuccess)
 	{
-		DrawDebugLine(GetWorld(), CamLoc + GetActorRightVector() * -GetCapsuleComponent()->GetUnscaledCapsuleRadius(), hit->Location, FColor::Green, false, 1.f, 0, 20.f);
+		DrawDebugLine(GetWorld(), CamLoc + GetActorRightVector() * -GetCapsuleComponent()->GetUnscaledCapsuleRadius(), hit.Location, FColor::Green, false, 1.f, 0, 20.f);
 
-		if ((hit->GetActor() != NULL) && (hit->GetComponent() != NULL))
+		if ((hit.GetActor() != NULL) && (hit.GetComponent() != NULL) && OmegaNet::IsGameplayAuthority(GetWorld()))
 		{
-			if (hit->GetComponent()->IsSimulatingPhysics())
+			AOmegaDamageQueue* Queue = AOmegaDamageQueue::Get(GetWorld());
+
+			if (hit.GetComponent()->IsSimulatingPhysics())
 			{
-				hit->GetComponent()->AddImpulseAtLocation((hit->TraceEnd - CamLoc).GetSafeNormal() * DefaultMeleeForce, GetActorLocation());
+				Queue->AddImpulse(hit.GetComponent(), (hit.TraceEnd - CamLoc).GetSafeNormal() * DefaultMeleeForce, GetActorLocation());
 			}
 
-			AOmegaCharacter* omegaActor = Cast<AOmegaCharacter>(hit->GetActor());
+			AOmegaCharacter* omegaActor = Cast<AOmegaCharacter>(hit.GetActor());
 
 			if (omegaActor)
 			{
-				omegaActor->ReceiveDamage(DefaultMeleeDamage);
+				Queue->AddDamage(omegaActor, DefaultMeleeDamage);
 			}
 		}
 	}
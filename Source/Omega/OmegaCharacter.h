@@ -4,10 +4,15 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "WorldCollision.h"
+#include "OmegaLagCompensation.h"
 #include "OmegaCharacter.generated.h"
 
 class UInputComponent;
 class UCharacterMovementComponent;
+struct FStreamableHandle;
+struct FOmegaActionInput;
+struct FOmegaAxisInput;
 
 UENUM(BlueprintType)
 enum class EQuickTurnDirection : uint8
@@ -36,6 +41,56 @@ enum class ECoverState : uint8
 	CS_COVER	UMETA(DisplayName = "In Cover")
 };
 
+/** the character behaviors that tick on their own, only while active */
+enum class EOmegaCharacterBehavior : uint8
+{
+	QuickTurn,
+	Slide,
+	Cover,
+	Reticle
+};
+
+/**
+ * Tick function for one character behavior. It runs AOmegaCharacter::TickBehavior and disables itself as soon as the
+ * behavior reports it's no longer active; the character re-enables it when the behavior starts again.
+ */
+USTRUCT()
+struct FOmegaBehaviorTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	class AOmegaCharacter* Target = nullptr;
+	EOmegaCharacterBehavior Behavior = EOmegaCharacterBehavior::QuickTurn;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FOmegaBehaviorTickFunction> : public TStructOpsTypeTraitsBase2<FOmegaBehaviorTickFunction>
+{
+	enum { WithCopy = false };
+};
+
+/** health and shield as a fraction of their max, a byte each - clients only display them */
+USTRUCT()
+struct FOmegaQuantizedVitals
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint8 Health = 0;
+	UPROPERTY()
+	uint8 Shield = 0;
+
+	bool operator==(const FOmegaQuantizedVitals& Other) const { return (Health == Other.Health) && (Shield == Other.Shield); }
+	bool operator!=(const FOmegaQuantizedVitals& Other) const { return !(*this == Other); }
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOmegaVitalChangedSignature, float, Current, float, Max);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOmegaReticleStateChangedSignature, EViewTargetState, NewState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOmegaWeaponChangedSignature, class AOmegaGunBase*, NewWeapon);
+
 UCLASS(config=Game)
 class AOmegaCharacter : public ACharacter
 {
@@ -65,8 +120,11 @@ protected:
 	virtual void BeginPlay();
 
 	virtual void Tick(float DeltaSeconds) override;
+	virtual void RegisterActorTickFunctions(bool bRegister) override;
 
 public:
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
 	float BaseTurnRate;
@@ -233,9 +291,31 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Reticle")
 	float NPCInteractDistance = 250.f;
 
+	/** runs the reticle trace asynchronously, the reticle state and aim location then lag one frame behind the camera */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Reticle")
+	bool bAsyncReticleTrace = false;
+	/** falls back to the synchronous reticle trace while scoped, where a frame of aim latency is noticeable */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Reticle")
+	bool bSyncReticleWhileScoped = true;
+
+	/** seconds between reticle updates on pawns that aren't locally controlled, nobody looks through their reticle */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Reticle", meta = (ClampMin = 0.f))
+	float RemoteReticleTickInterval = 0.2f;
+
 	UFUNCTION(BlueprintCallable, Category = "Reticle")
 	void UpdateReticleState();
 
+	/* change notifications for the HUD widgets, these only fire when the value actually changes */
+	UPROPERTY(BlueprintAssignable, Category = "Health")
+	FOmegaVitalChangedSignature OnHealthChanged;
+	UPROPERTY(BlueprintAssignable, Category = "Health")
+	FOmegaVitalChangedSignature OnShieldChanged;
+	UPROPERTY(BlueprintAssignable, Category = "Reticle")
+	FOmegaReticleStateChangedSignature OnReticleStateChanged;
+	/** fired when a weapon swap completes, so ammo displays can rebind to the new gun's OnAmmoChanged */
+	UPROPERTY(BlueprintAssignable, Category = "Gun")
+	FOmegaWeaponChangedSignature OnCurrentWeaponChanged;
+
 	/* this function handles the base action/interact/sprint/cover decision */
 	UFUNCTION(BlueprintCallable, Category = "Action")
 	void Action();
@@ -297,6 +377,13 @@ protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Swap", meta = (ClampMin = 0.5f, ClampMax = 3.f))
 	float WeaponSwapTime = 1.f;
 
+	/**
+	 * holstered weapon, streamed in after spawn rather than loaded and spawned with the pawn - used when the secondary
+	 * gun component has no class of its own. A swap started before it's in just takes a little longer than WeaponSwapTime.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category = "Weapon Swap")
+	TAssetSubclassOf<class AOmegaGunBase> SecondaryWeaponClass;
+
 	/** these variables and functions handle leaning behavior in cover */
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Leaning", meta = (ClampMin = 0.f, ClampMax = 100.f))
 	float LeanDisplacementMax = 50.f;
@@ -320,6 +407,10 @@ protected:
 	UPROPERTY(BlueprintReadWrite, Category = "Special")
 	bool IsSpecialReady = true;
 
+	// number of server ticks of capsule history kept for lag compensated hitscan
+	UPROPERTY(EditDefaultsOnly, Category = "Lag Compensation", meta = (ClampMin = 2, ClampMax = 256))
+	int32 PoseHistorySize = 64;
+
 private:
 	// original character values for reset after leaving sprint/crouch/aim/etc. states
 	float normalHeight = 0.f;
@@ -337,6 +428,28 @@ private:
 	// internal utility to trigger a reload on the gun
 	void StartReload();
 
+	// classifies the closest hit along the camera ray (or lack of one) into the reticle state and aim location
+	void ResolveReticleState(const FHitResult* Hit, const FVector& TraceEnd);
+#if WITH_DEV_AUTOMATION_TESTS
+	// the original resolver - a trace per interact distance plus one out to the max aim distance, classified by casting -
+	// kept so the reticle tests can check the single trace against it along the same ray
+	void ResolveReticleStateLegacy(const FVector& CamLoc, const FVector& Direction, EViewTargetState& OutState, FVector& OutAimLocation) const;
+#endif
+
+	// double-buffered async reticle trace results - the trace delegate fills the back buffer and flips, the tick reads the front one
+	struct FReticleTraceResult
+	{
+		FHitResult Hit;
+		FVector TraceEnd;
+		bool bHit = false;
+		bool bValid = false;
+	};
+	FReticleTraceResult ReticleTraceResults[2];
+	int32 ReticleReadIndex = 0;
+	FTraceHandle ReticleTraceHandle;
+	FTraceDelegate ReticleTraceDelegate;
+	void OnReticleTraceDone(const FTraceHandle& TraceHandle, FTraceDatum& TraceData);
+
 	FVector aimLocation;
 	FVector coverEntryLocation;
 
@@ -344,10 +457,63 @@ private:
 	bool IsWeaponPrimary = true;
 	FTimerHandle WeaponSwapTimerHandle;
 
+	// streaming state for SecondaryWeaponClass - every machine loads the class, the server spawns the gun and it replicates
+	TSharedPtr<FStreamableHandle> SecondaryWeaponLoadHandle;
+	bool bAwaitingSecondaryWeapon = false;
+	void RequestSecondaryWeaponLoad();
+	void OnSecondaryWeaponLoaded();
+
 	class APickup* OverlappedPickupRef;
 	bool IsOverlappingPickup = false;
 
 	FVector InitialLeanDisplacement;
+
+	// behaviors with their own tick functions, enabled only while the behavior is active
+	friend struct FOmegaBehaviorTickFunction;
+	// drives the systems directly to time them
+	friend class AOmegaBenchmark;
+	// drives the same calls the input bindings make
+	friend class AOmegaBotController;
+#if WITH_DEV_AUTOMATION_TESTS
+	friend class FOmegaReticleSweepCommand;
+	friend class FOmegaSteadyStateAllocationCommand;
+#endif
+	FOmegaBehaviorTickFunction QuickTurnTick;
+	FOmegaBehaviorTickFunction SlideTick;
+	FOmegaBehaviorTickFunction CoverTick;
+	FOmegaBehaviorTickFunction ReticleTick;
+	void InitBehaviorTick(FOmegaBehaviorTickFunction& TickFunction, EOmegaCharacterBehavior Behavior);
+	void ActivateBehaviorTick(FOmegaBehaviorTickFunction& TickFunction);
+	// runs one behavior for the frame, returns whether it's still active
+	bool TickBehavior(EOmegaCharacterBehavior Behavior, float DeltaTime);
+
+	// change-checking setters behind the notification delegates
+	void SetReticleState(EViewTargetState NewState);
+	void SetCurrentWeapon(class AOmegaGunBase* NewWeapon);
+	void BroadcastVitalsChanges(float PreviousHealth, float PreviousShield);
+
+	// re-reads the weapon refs from the child actor components, on clients the guns are replicated in after BeginPlay
+	void RefreshWeaponRefs();
+
+	// replicated vitals, only reassigned when the quantized value actually changes
+	UPROPERTY(ReplicatedUsing = OnRep_Vitals)
+	FOmegaQuantizedVitals ReplicatedVitals;
+	UFUNCTION()
+	void OnRep_Vitals();
+	void UpdateReplicatedVitals();
+
+	// crouch/sprint/scope/slide in the low bits, cover state above them - see PackStateFlags
+	UPROPERTY(ReplicatedUsing = OnRep_StateFlags)
+	uint8 ReplicatedStateFlags = 0;
+	UFUNCTION()
+	void OnRep_StateFlags();
+	uint8 PackStateFlags() const;
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerSetStateFlags(uint8 Flags);
+
+	// capsule samples recorded each server tick, rewound by hitscan validation
+	FOmegaPoseHistory PoseHistory;
+	bool ShouldRecordPoseHistory() const;
 	
 protected:
 	// APawn interface
@@ -355,10 +521,22 @@ protected:
 	// End of APawn interface
 
 public:
+	/** every action and axis the character binds, input replay drives the same handlers **/
+	static const TArray<FOmegaActionInput>& GetActionInputs();
+	static const TArray<FOmegaAxisInput>& GetAxisInputs();
+
 	/** Returns Mesh1P subobject **/
 	FORCEINLINE class USkeletalMeshComponent* GetMesh1P() const { return Mesh1P; }
 	/** Returns FirstPersonCameraComponent subobject **/
 	FORCEINLINE class UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
+	/** Returns the server-side capsule history **/
+	FORCEINLINE const FOmegaPoseHistory& GetPoseHistory() const { return PoseHistory; }
+	/** Returns the current reticle state **/
+	FORCEINLINE EViewTargetState GetReticleState() const { return ReticleState; }
+	/** Returns the weapon in hand **/
+	FORCEINLINE class AOmegaGunBase* GetCurrentWeapon() const { return CurrentWeapon; }
+	/** Returns whether health has run out **/
+	FORCEINLINE bool IsDead() const { return currentHealth <= 0.f; }
 
 
 	UFUNCTION(BlueprintCallable, Category = "Overlap")
@@ -367,3 +545,16 @@ public:
 	void ClearOverlappingReticle();
 };
 
+struct FOmegaActionInput
+{
+	FName Name;
+	// either may be null
+	void (AOmegaCharacter::*Pressed)();
+	void (AOmegaCharacter::*Released)();
+};
+
+struct FOmegaAxisInput
+{
+	FName Name;
+	void (AOmegaCharacter::*Handler)(float);
+};
@@ -0,0 +1,135 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaDamageQueue.h"
+#include "OmegaCharacter.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Omega.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events"), STAT_OmegaDamageEvents, STATGROUP_Omega);
+
+AOmegaDamageQueue::AOmegaDamageQueue()
+{
+	// resolve after physics and every actor tick have queued their hits for the frame
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+}
+
+namespace
+{
+	// every hit looks its world's queue up, so it's found here rather than by iterating the world's actors
+	TMap<TWeakObjectPtr<UWorld>, TWeakObjectPtr<AOmegaDamageQueue>> WorldQueues;
+}
+
+AOmegaDamageQueue* AOmegaDamageQueue::Get(UWorld* World)
+{
+	if (!World) return nullptr;
+
+	if (const TWeakObjectPtr<AOmegaDamageQueue>* Cached = WorldQueues.Find(World))
+	{
+		AOmegaDamageQueue* Queue = Cached->Get();
+		if (Queue && !Queue->IsPendingKillPending()) return Queue;
+	}
+
+	// one placed in the map may not have begun play yet
+	AOmegaDamageQueue* Queue = nullptr;
+	for (TActorIterator<AOmegaDamageQueue> It(World); It; ++It)
+	{
+		Queue = *It;
+		break;
+	}
+
+	if (!Queue)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		Queue = World->SpawnActor<AOmegaDamageQueue>(SpawnParams);
+	}
+
+	if (Queue) WorldQueues.Add(World, Queue);
+	return Queue;
+}
+
+void AOmegaDamageQueue::BeginPlay()
+{
+	Super::BeginPlay();
+
+	WorldQueues.Add(GetWorld(), this);
+}
+
+void AOmegaDamageQueue::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	const TWeakObjectPtr<AOmegaDamageQueue>* Cached = WorldQueues.Find(GetWorld());
+	if (Cached && (Cached->Get() == this)) WorldQueues.Remove(GetWorld());
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AOmegaDamageQueue::AddDamage(AOmegaCharacter* Victim, float Damage)
+{
+	if (!Victim || (Damage <= 0.f)) return;
+
+	INC_DWORD_STAT(STAT_OmegaDamageEvents);
+
+	// a handful of victims per frame at most, a linear search beats hashing
+	FPendingDamage* entry = PendingDamage.FindByPredicate([Victim](const FPendingDamage& Item) { return Item.Victim.Get() == Victim; });
+	if (entry) entry->Damage += Damage;
+	else PendingDamage.Add({ Victim, Damage });
+}
+
+void AOmegaDamageQueue::AddImpulse(UPrimitiveComponent* Component, const FVector& Impulse, const FVector& Location)
+{
+	if (!Component || Impulse.IsNearlyZero()) return;
+
+	const float weight = Impulse.Size();
+
+	FPendingImpulse* entry = PendingImpulses.FindByPredicate([Component](const FPendingImpulse& Item) { return Item.Component.Get() == Component; });
+	if (entry)
+	{
+		entry->Impulse += Impulse;
+		entry->WeightedLocation += Location * weight;
+		entry->Weight += weight;
+	}
+	else PendingImpulses.Add({ Component, Impulse, Location * weight, weight });
+}
+
+void AOmegaDamageQueue::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (PendingImpulses.Num() > 0) ResolveImpulses();
+	if (PendingDamage.Num() > 0) ResolveDamage();
+}
+
+void AOmegaDamageQueue::ResolveImpulses()
+{
+	for (const FPendingImpulse& entry : PendingImpulses)
+	{
+		UPrimitiveComponent* component = entry.Component.Get();
+		if (!component || !component->IsSimulatingPhysics()) continue;
+
+		component->AddImpulseAtLocation(entry.Impulse, entry.WeightedLocation / entry.Weight);
+	}
+
+	PendingImpulses.Reset();
+}
+
+void AOmegaDamageQueue::ResolveDamage()
+{
+	// listeners may queue more damage while this runs, that lands next frame
+	Swap(PendingDamage, ResolvingDamage);
+
+	for (const FPendingDamage& entry : ResolvingDamage)
+	{
+		AOmegaCharacter* victim = entry.Victim.Get();
+
+		// already dead characters don't die again
+		if (!victim || victim->IsDead()) continue;
+
+		victim->ReceiveDamage(entry.Damage);
+		OnDamaged.Broadcast(victim, entry.Damage, victim->IsDead());
+	}
+
+	ResolvingDamage.Reset();
+}
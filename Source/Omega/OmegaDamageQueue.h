@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "OmegaDamageQueue.generated.h"
+
+class AOmegaCharacter;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FOmegaDamagedSignature, AOmegaCharacter*, Victim, float, Damage, bool, bDied);
+
+/**
+ * World-level collection point for damage and physics impulses. Hits queue up during the frame and are resolved
+ * after everything has moved: each victim takes its summed damage in one ReceiveDamage call, each body gets one
+ * summed impulse, and OnDamaged fires once per victim - however many hits landed.
+ */
+UCLASS()
+class OMEGA_API AOmegaDamageQueue : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AOmegaDamageQueue();
+
+	/** returns the world's damage queue, spawning it on first use - cached per world, cheap enough to call per hit */
+	static AOmegaDamageQueue* Get(UWorld* World);
+
+	/** queues damage for Victim, resolved at the end of the frame */
+	void AddDamage(AOmegaCharacter* Victim, float Damage);
+	/** queues an impulse for a simulating body, resolved at the end of the frame */
+	void AddImpulse(UPrimitiveComponent* Component, const FVector& Impulse, const FVector& Location);
+
+	/** fired once per damaged victim per frame with the total damage taken */
+	UPROPERTY(BlueprintAssignable, Category = "Damage")
+	FOmegaDamagedSignature OnDamaged;
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+	void ResolveImpulses();
+	void ResolveDamage();
+
+	struct FPendingDamage
+	{
+		TWeakObjectPtr<AOmegaCharacter> Victim;
+		float Damage;
+	};
+	struct FPendingImpulse
+	{
+		TWeakObjectPtr<UPrimitiveComponent> Component;
+		FVector Impulse;
+		// impulse-weighted sum of the hit locations, divided out when applied
+		FVector WeightedLocation;
+		float Weight;
+	};
+
+	TArray<FPendingDamage> PendingDamage;
+	TArray<FPendingDamage> ResolvingDamage;
+	TArray<FPendingImpulse> PendingImpulses;
+};
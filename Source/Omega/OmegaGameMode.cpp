@@ -4,6 +4,20 @@
 #include "OmegaHUD.h"
 #include "OmegaCharacter.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Engine/StreamableManager.h"
+#include "TimerManager.h"
+#include "Omega.h"
+#include "OmegaBenchmark.h"
+#include "OmegaTelemetry.h"
+#include "OmegaInputReplay.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmegaNet, Log, All);
+DEFINE_LOG_CATEGORY_STATIC(LogOmegaStartup, Log, All);
 
 AOmegaGameMode::AOmegaGameMode()
 	: Super()
@@ -15,3 +29,159 @@ AOmegaGameMode::AOmegaGameMode()
 	// use our custom HUD class
 	HUDClass = AOmegaHUD::StaticClass();
 }
+
+void AOmegaGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	InitGameTime = FPlatformTime::Seconds();
+
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("OmegaTelemetry")))
+	{
+		FOmegaTelemetry::StartSession(FPaths::GetBaseFilename(MapName) + TEXT("-") + FDateTime::Now().ToString());
+	}
+
+	TArray<FStringAssetReference> assetsToLoad;
+	for (const FStringAssetReference& asset : PreloadAssets)
+	{
+		if (asset.IsValid()) assetsToLoad.AddUnique(asset);
+	}
+
+	if (assetsToLoad.Num() == 0)
+	{
+		PreloadCompleteTime = InitGameTime;
+		return;
+	}
+
+	// the rest of the map loads in the meantime, the completion callback runs on the game thread
+	bIsPreloading = true;
+	PreloadHandle = OmegaAssets::GetStreamableManager().RequestAsyncLoad(assetsToLoad,
+		FStreamableDelegate::CreateUObject(this, &AOmegaGameMode::OnPreloadComplete), FStreamableManager::AsyncLoadHighPriority);
+}
+
+void AOmegaGameMode::StartPlay()
+{
+	StartPlayTime = FPlatformTime::Seconds();
+
+	Super::StartPlay();
+
+	// both wait for the player's character, so they can start this early
+	FString recordingName;
+	if (FParse::Value(FCommandLine::Get(), TEXT("OmegaRecord="), recordingName)) OmegaRecordInput(recordingName);
+	else if (FParse::Value(FCommandLine::Get(), TEXT("OmegaReplay="), recordingName)) OmegaReplayInput(recordingName, FParse::Param(FCommandLine::Get(), TEXT("OmegaReplayQuit")));
+}
+
+void AOmegaGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FOmegaTelemetry::StopSession();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AOmegaGameMode::OnPreloadComplete()
+{
+	if (!bIsPreloading) return;
+
+	bIsPreloading = false;
+	PreloadCompleteTime = FPlatformTime::Seconds();
+	UE_LOG(LogOmegaStartup, Log, TEXT("preload finished in %.1f ms"), (PreloadCompleteTime - InitGameTime) * 1000.0);
+
+	// restarting may log more players in, work off a copy
+	TArray<AController*> deferred = MoveTemp(DeferredRestarts);
+	DeferredRestarts.Reset();
+
+	for (AController* controller : deferred)
+	{
+		if (controller && !controller->IsPendingKill() && !controller->GetPawn()) RestartPlayer(controller);
+	}
+}
+
+void AOmegaGameMode::RestartPlayer(AController* NewPlayer)
+{
+	if (bIsPreloading)
+	{
+		// nobody gets a pawn until nothing is left to hitch on
+		if (NewPlayer) DeferredRestarts.AddUnique(NewPlayer);
+		return;
+	}
+
+	Super::RestartPlayer(NewPlayer);
+
+	if ((FirstRestartTime == 0.0) && NewPlayer && NewPlayer->GetPawn() && NewPlayer->IsPlayerController())
+	{
+		FirstRestartTime = FPlatformTime::Seconds();
+		INC_DWORD_STAT(STAT_OmegaTimersArmed);
+		OmegaStats::TimersArmed++;
+		GetWorldTimerManager().SetTimerForNextTick(this, &AOmegaGameMode::OnFirstControllableFrame);
+	}
+}
+
+void AOmegaGameMode::OnFirstControllableFrame()
+{
+	FirstControllableFrameTime = FPlatformTime::Seconds();
+	OmegaStartupReport();
+}
+
+void AOmegaGameMode::OmegaStartupReport()
+{
+	// GStartTime is taken when the process starts
+	auto sinceStart = [](double Time) { return (Time > 0.0) ? (Time - GStartTime) * 1000.0 : -1.0; };
+	auto between = [](double From, double To) { return ((From > 0.0) && (To > 0.0)) ? (To - From) * 1000.0 : -1.0; };
+
+	UE_LOG(LogOmegaStartup, Log, TEXT("startup (ms, -1 = not reached):"));
+	UE_LOG(LogOmegaStartup, Log, TEXT("  engine + map load to InitGame    %9.1f"), sinceStart(InitGameTime));
+	UE_LOG(LogOmegaStartup, Log, TEXT("  InitGame to StartPlay            %9.1f"), between(InitGameTime, StartPlayTime));
+	UE_LOG(LogOmegaStartup, Log, TEXT("  preload (from InitGame)          %9.1f"), between(InitGameTime, PreloadCompleteTime));
+	UE_LOG(LogOmegaStartup, Log, TEXT("  StartPlay to first pawn          %9.1f"), between(StartPlayTime, FirstRestartTime));
+	UE_LOG(LogOmegaStartup, Log, TEXT("  first pawn to controllable frame %9.1f"), between(FirstRestartTime, FirstControllableFrameTime));
+	UE_LOG(LogOmegaStartup, Log, TEXT("  total to first controllable frame %8.1f"), sinceStart(FirstControllableFrameTime));
+}
+
+void AOmegaGameMode::OmegaBenchmark(int32 NumCharacters, int32 FramesPerCase, bool bQuitWhenDone)
+{
+	AOmegaBenchmark::Start(GetWorld(), NumCharacters, FramesPerCase, bQuitWhenDone);
+}
+
+void AOmegaGameMode::OmegaRecordInput(const FString& RecordingName)
+{
+	AOmegaInputReplay::StartRecording(GetWorld(), RecordingName);
+}
+
+void AOmegaGameMode::OmegaReplayInput(const FString& RecordingName, bool bQuitWhenDone)
+{
+	AOmegaInputReplay::StartReplay(GetWorld(), RecordingName, bQuitWhenDone);
+}
+
+void AOmegaGameMode::OmegaStopInput()
+{
+	AOmegaInputReplay::Stop(GetWorld());
+}
+
+void AOmegaGameMode::OmegaNetReport()
+{
+	UNetDriver* netDriver = GetWorld()->GetNetDriver();
+	if (!netDriver)
+	{
+		UE_LOG(LogOmegaNet, Log, TEXT("OmegaNetReport: no net driver, not a networked session"));
+		return;
+	}
+
+	int32 totalOut = 0;
+	int32 totalIn = 0;
+
+	for (UNetConnection* connection : netDriver->ClientConnections)
+	{
+		if (!connection) continue;
+
+		APlayerController* playerController = connection->PlayerController;
+		const FString playerName = (playerController && playerController->PlayerState) ? playerController->PlayerState->PlayerName : connection->LowLevelGetRemoteAddress();
+
+		UE_LOG(LogOmegaNet, Log, TEXT("%-24s out %6d B/s  in %6d B/s  ping %4.0f ms"), *playerName, connection->OutBytesPerSecond, connection->InBytesPerSecond, connection->AvgLag * 1000.f);
+
+		totalOut += connection->OutBytesPerSecond;
+		totalIn += connection->InBytesPerSecond;
+	}
+
+	const int32 numConnections = FMath::Max(netDriver->ClientConnections.Num(), 1);
+	UE_LOG(LogOmegaNet, Log, TEXT("%d connections, total out %d B/s (%d per connection), total in %d B/s"), netDriver->ClientConnections.Num(), totalOut, totalOut / numConnections, totalIn);
+}
@@ -6,13 +6,68 @@
 #include "GameFramework/GameModeBase.h"
 #include "OmegaGameMode.generated.h"
 
-UCLASS(minimalapi)
+struct FStreamableHandle;
+
+UCLASS(minimalapi, config=Game)
 class AOmegaGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
 
 public:
 	AOmegaGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void StartPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void RestartPlayer(AController* NewPlayer) override;
+
+	/** logs outgoing/incoming bytes per second for every client connection, run it on the listen server or dedicated server */
+	UFUNCTION(Exec)
+	void OmegaNetReport();
+
+	/** logs where the time to the first controllable frame went, see the startup timestamps below */
+	UFUNCTION(Exec)
+	void OmegaStartupReport();
+
+	/** times the gameplay systems over NumCharacters spawned characters and writes the results to Saved/Benchmarks, see AOmegaBenchmark */
+	UFUNCTION(Exec)
+	void OmegaBenchmark(int32 NumCharacters = 16, int32 FramesPerCase = 300, bool bQuitWhenDone = false);
+
+	/** records the local player's input to Saved/InputRecordings until OmegaStopInput, see AOmegaInputReplay */
+	UFUNCTION(Exec)
+	void OmegaRecordInput(const FString& RecordingName);
+	/** plays a recording back through the local player's character and writes its frame times to Saved/Benchmarks */
+	UFUNCTION(Exec)
+	void OmegaReplayInput(const FString& RecordingName, bool bQuitWhenDone = false);
+	UFUNCTION(Exec)
+	void OmegaStopInput();
+
+protected:
+	/**
+	 * content that would otherwise load synchronously on first use - weapons, projectiles, pickups, sounds, widgets.
+	 * Streamed in from InitGame while the map finishes loading, players aren't spawned until it's all resident.
+	 */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Preload")
+	TArray<FStringAssetReference> PreloadAssets;
+
+private:
+	void OnPreloadComplete();
+	void OnFirstControllableFrame();
+
+	// keeps the preloaded content resident for the rest of the match
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+	bool bIsPreloading = false;
+
+	// players that logged in before the preload finished, restarted once it has
+	UPROPERTY()
+	TArray<AController*> DeferredRestarts;
+
+	// FPlatformTime::Seconds() at each startup milestone, zero until reached
+	double InitGameTime = 0.0;
+	double StartPlayTime = 0.0;
+	double PreloadCompleteTime = 0.0;
+	double FirstRestartTime = 0.0;
+	double FirstControllableFrameTime = 0.0;
 };
 
 
@@ -1,101 +1,361 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "OmegaGunBase.h"
+#include "Omega.h"
 #include "Components/SkeletalMeshComponent.h"
-#include "Runtime/Engine/Public/TimerManager.h"
 #include "OmegaProjectile.h"
+#include "OmegaProjectilePool.h"
+#include "OmegaBulletManager.h"
+#include "OmegaDamageQueue.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "Kismet/GameplayStatics.h"
 #include "Kismet/KismetMathLibrary.h"
 #include "OmegaCharacter.h"
+#include "OmegaLagCompensation.h"
+#include "OmegaTelemetry.h"
+#include "GameFramework/PlayerState.h"
+#include "GameFramework/PlayerController.h"
 #include "DrawDebugHelpers.h"
+#include "TimerManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Net/UnrealNetwork.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Predicted Shots Pending"), STAT_OmegaPredictedShotsPending, STATGROUP_Omega);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Predicted Shots Rejected"), STAT_OmegaPredictedShotsRejected, STATGROUP_Omega);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Shot Confirm Latency (ms)"), STAT_OmegaShotConfirmLatency, STATGROUP_Omega);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Weapon Ticks"), STAT_OmegaWeaponTicks, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("PrimaryFire"), STAT_OmegaPrimaryFire, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("FireHitscan"), STAT_OmegaFireHitscan, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("FirePelletHitscan"), STAT_OmegaFirePellet, STATGROUP_Omega);
+DECLARE_CYCLE_STAT(TEXT("FireProjectile"), STAT_OmegaFireProjectile, STATGROUP_Omega);
+
+static TAutoConsoleVariable<int32> CVarOmegaDrawHitscan(
+	TEXT("Omega.DrawHitscan"),
+	0,
+	TEXT("Draws a debug line along every hitscan ray and pellet.\n")
+	TEXT("0: off\n")
+	TEXT("1: on"),
+	ECVF_Cheat);
 
 // Sets default values
 AOmegaGunBase::AOmegaGunBase()
 {
- 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+ 	// the weapon only ticks while it has a fire schedule to advance or predicted shots to expire, see WakeTick
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 
 	GunSkeleton = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("GunSkeleton"));
 	RootComponent = GunSkeleton;
+
+	// ammo only changes when the owner fires, reloads or picks something up - those changes force an update, see NotifyAmmoChanged
+	bReplicates = true;
+	NetUpdateFrequency = 5.f;
+}
+
+void AOmegaGunBase::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// nobody but the owner displays ammo
+	DOREPLIFETIME_CONDITION(AOmegaGunBase, currentClipAmmo, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(AOmegaGunBase, currentGunAmmo, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(AOmegaGunBase, currentSecondaryCharges, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(AOmegaGunBase, bIsReloading, COND_OwnerOnly);
+	DOREPLIFETIME_CONDITION(AOmegaGunBase, ServerReloadCount, COND_OwnerOnly);
+
+	// a swap changes fire sound and projectiles too, everybody gets it
+	DOREPLIFETIME(AOmegaGunBase, Archetype);
+}
+
+void AOmegaGunBase::PostLoad()
+{
+	Super::PostLoad();
+
+	MigrateDeprecatedTuning();
+}
+
+void AOmegaGunBase::MigrateDeprecatedTuning()
+{
+	// an archetype chosen since supersedes whatever was saved before it, and guns of a migrated class share their class's
+	if (Archetype) return;
+
+	const UOmegaWeaponArchetype* Defaults = GetDefault<UOmegaWeaponArchetype>();
+	const bool bHasTuning = (totalAmmoMax_DEPRECATED != Defaults->totalAmmoMax) || (clipAmmoMax_DEPRECATED != Defaults->clipAmmoMax)
+		|| (clipSecondaryChargeMax_DEPRECATED != Defaults->clipSecondaryChargeMax) || (SecondaryRechargeTimer_DEPRECATED != Defaults->SecondaryRechargeTimer)
+		|| (ProjectileClass_DEPRECATED != Defaults->ProjectileClass) || (SecondaryProjectileClass_DEPRECATED != Defaults->SecondaryProjectileClass)
+		|| (PrimaryFireSound_DEPRECATED != Defaults->PrimaryFireSound) || (SecondaryFireSound_DEPRECATED != Defaults->SecondaryFireSound)
+		|| (TriggerConfig != Defaults->TriggerConfig) || (BurstCount != Defaults->BurstCount)
+		|| (SingleFireRate_DEPRECATED != Defaults->SingleFireRate) || (AutoFireRate_DEPRECATED != Defaults->AutoFireRate)
+		|| (BurstFireSpread_DEPRECATED != Defaults->BurstFireSpread) || (AutoFireSpreadThreshold_DEPRECATED != Defaults->AutoFireSpreadThreshold)
+		|| (MaxAutoFireSpread_DEPRECATED != Defaults->MaxAutoFireSpread) || (DefaultHitscanDamage_DEPRECATED != Defaults->DefaultHitscanDamage)
+		|| (DefaultHitscanForce_DEPRECATED != Defaults->DefaultHitscanForce) || (HitscanRangeBuffer_DEPRECATED != Defaults->HitscanRangeBuffer);
+	if (!bHasTuning) return;
+
+	// named so the server and its clients build the same object path for it
+	UOmegaWeaponArchetype* Migrated = NewObject<UOmegaWeaponArchetype>(this, TEXT("MigratedArchetype"), GetMaskedFlags(RF_PropagateToSubObjects) | RF_Public);
+	Migrated->totalAmmoMax = totalAmmoMax_DEPRECATED;
+	Migrated->clipAmmoMax = clipAmmoMax_DEPRECATED;
+	Migrated->clipSecondaryChargeMax = clipSecondaryChargeMax_DEPRECATED;
+	Migrated->SecondaryRechargeTimer = SecondaryRechargeTimer_DEPRECATED;
+	Migrated->ProjectileClass = ProjectileClass_DEPRECATED;
+	Migrated->SecondaryProjectileClass = SecondaryProjectileClass_DEPRECATED;
+	Migrated->PrimaryFireSound = PrimaryFireSound_DEPRECATED;
+	Migrated->SecondaryFireSound = SecondaryFireSound_DEPRECATED;
+	Migrated->TriggerConfig = TriggerConfig;
+	Migrated->BurstCount = BurstCount;
+	Migrated->SingleFireRate = SingleFireRate_DEPRECATED;
+	Migrated->AutoFireRate = AutoFireRate_DEPRECATED;
+	Migrated->BurstFireSpread = BurstFireSpread_DEPRECATED;
+	Migrated->AutoFireSpreadThreshold = AutoFireSpreadThreshold_DEPRECATED;
+	Migrated->MaxAutoFireSpread = MaxAutoFireSpread_DEPRECATED;
+	Migrated->DefaultHitscanDamage = DefaultHitscanDamage_DEPRECATED;
+	Migrated->DefaultHitscanForce = DefaultHitscanForce_DEPRECATED;
+	Migrated->HitscanRangeBuffer = HitscanRangeBuffer_DEPRECATED;
+	Archetype = Migrated;
+}
+
+void AOmegaGunBase::SetArchetype(UOmegaWeaponArchetype* NewArchetype)
+{
+	if (NewArchetype == Archetype) return;
+
+	Archetype = NewArchetype;
+	ApplyArchetype();
+
+	if (!HasAuthority()) ServerSetArchetype(NewArchetype);
+	else if (GetNetMode() != NM_Standalone) ForceNetUpdate();
+}
+
+bool AOmegaGunBase::ServerSetArchetype_Validate(UOmegaWeaponArchetype* NewArchetype)
+{
+	// back to the authored archetype, or on to one the gun lists - anything else is a client making up its own tuning
+	if ((NewArchetype == Archetype) || (NewArchetype == GetClass()->GetDefaultObject<AOmegaGunBase>()->Archetype)) return true;
+	return AllowedArchetypes.Contains(NewArchetype);
+}
+
+void AOmegaGunBase::ServerSetArchetype_Implementation(UOmegaWeaponArchetype* NewArchetype)
+{
+	SetArchetype(NewArchetype);
+}
+
+void AOmegaGunBase::OnRep_Archetype()
+{
+	// ammo is the server's to clamp and replicates on its own, this picks up the new backends and charge max
+	ApplyArchetype();
+}
+
+void AOmegaGunBase::ApplyArchetype()
+{
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
+
+	// a fire cycle already under way finishes on the old rates, the next one picks up the new ones
+	TriggerConfig = Tuning->TriggerConfig;
+	BurstCount = Tuning->BurstCount;
+
+	if (HasAuthority())
+	{
+		currentClipAmmo = FMath::Min(currentClipAmmo, Tuning->clipAmmoMax);
+		currentGunAmmo = FMath::Min(currentGunAmmo, Tuning->totalAmmoMax);
+		currentSecondaryCharges = FMath::Min(currentSecondaryCharges, Tuning->clipSecondaryChargeMax);
+	}
+	// the charge max goes out with the charge count, resend it
+	NotifiedSecondaryCharges = INDEX_NONE;
+	NotifyAmmoChanged();
+
+	UWorld* const World = GetWorld();
+	if (!World || !World->IsGameWorld()) return;
+
+	if ((Tuning->ProjectileBackend == EProjectileBackend::PB_Pooled) || (Tuning->SecondaryProjectileBackend == EProjectileBackend::PB_Pooled))
+	{
+		if (!ProjectilePool) ProjectilePool = AOmegaProjectilePool::Get(World);
+		if (Tuning->ProjectileBackend == EProjectileBackend::PB_Pooled) ProjectilePool->Prewarm(Tuning->ProjectileClass);
+		if (Tuning->SecondaryProjectileBackend == EProjectileBackend::PB_Pooled) ProjectilePool->Prewarm(Tuning->SecondaryProjectileClass);
+	}
+
+	if ((Tuning->ProjectileBackend == EProjectileBackend::PB_Simulated) || (Tuning->SecondaryProjectileBackend == EProjectileBackend::PB_Simulated))
+	{
+		if (!BulletManager) BulletManager = AOmegaBulletManager::Get(World);
+	}
+}
+
+void AOmegaGunBase::NotifyAmmoChanged()
+{
+	if (HasAuthority() && (GetNetMode() != NM_Standalone)) ForceNetUpdate();
+
+	if ((currentClipAmmo != NotifiedClipAmmo) || (currentGunAmmo != NotifiedGunAmmo))
+	{
+		NotifiedClipAmmo = currentClipAmmo;
+		NotifiedGunAmmo = currentGunAmmo;
+		OnAmmoChanged.Broadcast(currentClipAmmo, currentGunAmmo);
+	}
+
+	if (currentSecondaryCharges != NotifiedSecondaryCharges)
+	{
+		NotifiedSecondaryCharges = currentSecondaryCharges;
+		OnChargeCountChanged.Broadcast(currentSecondaryCharges, GetArchetype()->clipSecondaryChargeMax);
+	}
+}
+
+void AOmegaGunBase::OnRep_AmmoState()
+{
+	NotifyAmmoChanged();
 }
 
 void AOmegaGunBase::ResetIsAbleToFire()
 {
 	IsAbleToFire = true;
 	AutoFireCount = 0;
-	if (OwningPlayerRef && IsTriggerHeld) PrimaryFire(OwningPlayerRef->GetAimLocation());
+	if (OwningPlayerRef && IsTriggerHeld) PrimaryFire(GetScheduledAimLocation());
 }
 
 void AOmegaGunBase::AutomaticFire()
 {
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
 	AutoFireCount++;
 
 	if (!IsTriggerHeld)
 	{
-		PrimaryFireRateTimerHandle.Invalidate();
-		GetWorldTimerManager().SetTimer(PrimaryFireRateTimerHandle, this, &AOmegaGunBase::ResetIsAbleToFire, SingleFireRate);
+		ScheduleFireEvent(&AOmegaGunBase::ResetIsAbleToFire, Tuning->SingleFireRate);
 	}
 	else
 	{
 		IsAbleToFire = true;
 
-		FVector PlayerAimLocation = OwningPlayerRef->GetAimLocation();
-		if ((AutoFireRate < SingleFireRate) && (AutoFireCount > AutoFireSpreadThreshold))
+		FVector PlayerAimLocation = GetScheduledAimLocation();
+		if ((Tuning->AutoFireRate < Tuning->SingleFireRate) && (AutoFireCount > Tuning->AutoFireSpreadThreshold))
 		{
 			FVector AimRotation = OwningPlayerRef->GetControlRotation().Vector();
 			FVector AimUpVector = UKismetMathLibrary::Cross_VectorVector(AimRotation, OwningPlayerRef->GetActorRightVector());
 			FVector AimRightVector = UKismetMathLibrary::Cross_VectorVector(AimRotation, OwningPlayerRef->GetActorUpVector());
-			float YSpread = FMath::RandRange(-MaxAutoFireSpread, MaxAutoFireSpread);
-			float ZSpread = FMath::RandRange(-MaxAutoFireSpread, MaxAutoFireSpread);
+			float YSpread = FMath::RandRange(-Tuning->MaxAutoFireSpread, Tuning->MaxAutoFireSpread);
+			float ZSpread = FMath::RandRange(-Tuning->MaxAutoFireSpread, Tuning->MaxAutoFireSpread);
 
 			PlayerAimLocation = PlayerAimLocation + (AimUpVector * ZSpread) + (AimRightVector * YSpread);
 		}
 
 		PrimaryFire(PlayerAimLocation);
-		GetWorldTimerManager().SetTimer(PrimaryFireRateTimerHandle, this, &AOmegaGunBase::AutomaticFire, AutoFireRate);
+		ScheduleFireEvent(&AOmegaGunBase::AutomaticFire, Tuning->AutoFireRate);
 	}
 }
 
 void AOmegaGunBase::BurstFire()
 {
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
 	AutoFireCount++;
 	BurstRemaining--;
 
 	if (BurstRemaining == 0 && IsBurstActive)
 	{
-		PrimaryFireRateTimerHandle.Invalidate();
 		IsBurstActive = false;
-		GetWorldTimerManager().SetTimer(PrimaryFireRateTimerHandle, this, &AOmegaGunBase::ResetIsAbleToFire, SingleFireRate);
+		ScheduleFireEvent(&AOmegaGunBase::ResetIsAbleToFire, Tuning->SingleFireRate);
 	}
 	else
 	{
 		IsAbleToFire = true;
 
-		FVector PlayerAimLocation = OwningPlayerRef->GetAimLocation();
-		if (AutoFireRate < SingleFireRate)
+		FVector PlayerAimLocation = GetScheduledAimLocation();
+		if (Tuning->AutoFireRate < Tuning->SingleFireRate)
 		{
 			FVector AimRotation = OwningPlayerRef->GetControlRotation().Vector();
 			FVector AimUpVector = UKismetMathLibrary::Cross_VectorVector(AimRotation, OwningPlayerRef->GetActorRightVector());
-			float ZSpread = FMath::RandRange(-MaxAutoFireSpread, MaxAutoFireSpread);
+			float ZSpread = FMath::RandRange(-Tuning->MaxAutoFireSpread, Tuning->MaxAutoFireSpread);
 
-			PlayerAimLocation = PlayerAimLocation + (AimUpVector * (BurstFireSpread * AutoFireCount));
+			PlayerAimLocation = PlayerAimLocation + (AimUpVector * (Tuning->BurstFireSpread * AutoFireCount));
 		}
 
 		PrimaryFire(PlayerAimLocation);
-		GetWorldTimerManager().SetTimer(PrimaryFireRateTimerHandle, this, &AOmegaGunBase::BurstFire, AutoFireRate);
+		ScheduleFireEvent(&AOmegaGunBase::BurstFire, Tuning->AutoFireRate);
 	}
 }
 
+float AOmegaGunBase::GetSpreadExtent() const
+{
+	// mirrors the spread applied in AutomaticFire and BurstFire
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
+	if (Tuning->AutoFireRate >= Tuning->SingleFireRate) return 0.f;
+	if (TriggerConfig == EFireMode::FM_Burst) return Tuning->BurstFireSpread * AutoFireCount;
+
+	return (AutoFireCount > Tuning->AutoFireSpreadThreshold) ? Tuning->MaxAutoFireSpread : 0.f;
+}
+
 void AOmegaGunBase::SetOwningPlayerRef(AOmegaCharacter* OwningPlayer)
 {
 	OwningPlayerRef = OwningPlayer;
+
+	// owner-only ammo replication follows the owner chain to the player's connection
+	if (HasAuthority()) SetOwner(OwningPlayer);
+
+	// the fire schedule reads the owner's aim location, make sure it's this frame's
+	if (OwningPlayerRef) AddTickPrerequisiteActor(OwningPlayerRef);
+}
+
+bool AOmegaGunBase::IsFireCycleActive() const
+{
+	return PendingFireEvent != nullptr;
 }
 
-FTimerHandle AOmegaGunBase::GetPrimaryFireTimerHandle()
+void AOmegaGunBase::ScheduleFireEvent(FFireEvent Event, float Delay)
 {
-	return PrimaryFireRateTimerHandle;
+	// an idle schedule has no previous frame to interpolate from
+	if (!PendingFireEvent && !bIsAdvancingFireSchedule) CaptureFireScheduleFrame();
+
+	// events armed while another is being processed keep its overshoot, so the cadence doesn't drift with the frame rate
+	PendingFireEvent = Event;
+	FireEventDelay = FireScheduleCarry + FMath::Max(Delay, MinFireEventInterval);
+
+	// armed from idle (i.e. from input), this frame's tick has already been missed - count this frame against the delay
+	if (WakeTick()) FireEventDelay -= GetWorld()->GetDeltaSeconds();
+}
+
+bool AOmegaGunBase::WakeTick()
+{
+	if (bTickedExternally || IsActorTickEnabled()) return false;
+
+	SetActorTickEnabled(true);
+	return true;
+}
+
+void AOmegaGunBase::AdvanceFireSchedule(float DeltaTime)
+{
+	if (!PendingFireEvent) return;
+
+	FireEventDelay -= DeltaTime;
+
+	// emit every event that came due during this frame, each at its own point within the frame
+	bIsAdvancingFireSchedule = true;
+	while (PendingFireEvent && FireEventDelay <= 0.f)
+	{
+		FFireEvent Event = PendingFireEvent;
+		PendingFireEvent = nullptr;
+
+		FireScheduleCarry = FireEventDelay;
+		FireScheduleAlpha = (DeltaTime > 0.f) ? FMath::Clamp(1.f + FireEventDelay / DeltaTime, 0.f, 1.f) : 1.f;
+
+		(this->*Event)();
+	}
+
+	bIsAdvancingFireSchedule = false;
+	FireScheduleCarry = 0.f;
+	FireScheduleAlpha = 1.f;
+
+	CaptureFireScheduleFrame();
+}
+
+void AOmegaGunBase::CaptureFireScheduleFrame()
+{
+	PreviousMuzzleLocation = GunSkeleton->GetSocketLocation("Muzzle");
+	PreviousAimLocation = (OwningPlayerRef) ? OwningPlayerRef->GetAimLocation() : PreviousMuzzleLocation;
+}
+
+FVector AOmegaGunBase::GetScheduledAimLocation() const
+{
+	FVector CurrentAimLocation = (OwningPlayerRef) ? OwningPlayerRef->GetAimLocation() : PreviousAimLocation;
+	return FMath::Lerp(PreviousAimLocation, CurrentAimLocation, FireScheduleAlpha);
+}
+
+FVector AOmegaGunBase::GetScheduledMuzzleLocation() const
+{
+	return FMath::Lerp(PreviousMuzzleLocation, GunSkeleton->GetSocketLocation("Muzzle"), FireScheduleAlpha);
 }
 
 // Called when the game starts or when spawned
@@ -103,37 +363,90 @@ void AOmegaGunBase::BeginPlay()
 {
 	Super::BeginPlay();
 
-	currentClipAmmo = clipAmmoMax;
-	currentGunAmmo = totalAmmoMax;
+	if (HasAuthority())
+	{
+		const UOmegaWeaponArchetype* Tuning = GetArchetype();
+		currentClipAmmo = Tuning->clipAmmoMax;
+		currentGunAmmo = Tuning->totalAmmoMax;
+
+		currentSecondaryCharges = Tuning->clipSecondaryChargeMax;
+		NotifyAmmoChanged();
+	}
+	else if (!OwningPlayerRef)
+	{
+		// replicated guns arrive on clients with their owner already set
+		SetOwningPlayerRef(Cast<AOmegaCharacter>(GetOwner()));
+	}
 
-	currentSecondaryCharges = clipSecondaryChargeMax;
+	if (OmegaNet::IsGameplayAuthority(GetWorld())) DamageQueue = AOmegaDamageQueue::Get(GetWorld());
 
-	ReloadTimer = *(new FTimerHandle());	
+	ApplyArchetype();
 }
 
 void AOmegaGunBase::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+
+	INC_DWORD_STAT(STAT_OmegaWeaponTicks);
+
+	AdvanceFireSchedule(DeltaTime);
+
+	if (PendingShots.Num() > 0) ExpirePendingShots();
+
+	// nothing left to advance, sleep until the next shot
+	if (!PendingFireEvent && (PendingShots.Num() == 0)) SetActorTickEnabled(false);
+}
+
+void AOmegaGunBase::RefreshAmmoState()
+{
+	const float now = GetWorld()->GetTimeSeconds();
+
+	if ((ReloadCompleteTime >= 0.f) && (now >= ReloadCompleteTime)) Reload();
+
+	while ((ChargeReadyCount > 0) && (now >= ChargeReadyTimes[ChargeReadyHead])) AddCharge();
 }
 
 void AOmegaGunBase::Reload()
 {
-	if (currentGunAmmo == 0) return;
+	if (currentGunAmmo == 0)
+	{
+		EndReload();
+		return;
+	}
 
+	const int32 clipAmmoMax = GetArchetype()->clipAmmoMax;
 	int32 bulletsNeeded = clipAmmoMax - currentClipAmmo;
 	currentClipAmmo = ((currentGunAmmo - bulletsNeeded) >= 0) ? clipAmmoMax : currentGunAmmo + currentClipAmmo;
 	currentGunAmmo = FMath::Max(currentGunAmmo - bulletsNeeded, 0);
+	EndReload();
+
+	ReloadCount++;
+	if (HasAuthority()) ServerReloadCount = ReloadCount;
+	NotifyAmmoChanged();
+}
+
+bool AOmegaGunBase::IsHeldByLocalPlayer() const
+{
+	return OwningPlayerRef && OwningPlayerRef->IsLocallyControlled() && Cast<APlayerController>(OwningPlayerRef->GetController());
+}
+
+void AOmegaGunBase::EndReload()
+{
+	ReloadCompleteTime = -1.f;
+	bIsReloading = false;
 	GetWorldTimerManager().ClearTimer(ReloadTimer);
 }
 
 void AOmegaGunBase::FireProjectile(TSubclassOf<AOmegaProjectile> projectile, const FVector& AimTarget)
 {
+	SCOPE_CYCLE_COUNTER(STAT_OmegaFireProjectile);
+
 	UWorld* const World = GetWorld();
 	if (World)
 	{
 		// TODO: once weapon gimbal in place, rework to use combined "weapon rotation" vector instead of control rotation
-		FVector MuzzleLocation = GunSkeleton->GetSocketLocation("Muzzle");
-		FRotator MuzzleRotation = UGameplayStatics::GetPlayerController(this, 0)->GetControlRotation();
+		FVector MuzzleLocation = GetScheduledMuzzleLocation();
+		FRotator MuzzleRotation = OwningPlayerRef->GetControlRotation();
 		const FVector SpawnLocation = MuzzleLocation + MuzzleRotation.RotateVector(FVector::ForwardVector * 50.f);
 		FRotator AimRotation = UKismetMathLibrary::FindLookAtRotation(SpawnLocation, AimTarget);
 
@@ -143,11 +456,31 @@ void AOmegaGunBase::FireProjectile(TSubclassOf<AOmegaProjectile> projectile, con
 		FActorSpawnParameters ActorSpawnParams;
 		ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
 
-		// spawn the projectile at the muzzle
-		AOmegaProjectile* SpawnedProjectile = World->SpawnActor<AOmegaProjectile>(projectile, SpawnLocation, AimRotation, ActorSpawnParams);
-		if (!SpawnedProjectile) 
+		// spawn the projectile at the muzzle, or take one from the pool, or hand it to the bullet simulation
+		const UOmegaWeaponArchetype* Tuning = GetArchetype();
+		EProjectileBackend Backend = (projectile == Tuning->SecondaryProjectileClass) ? Tuning->SecondaryProjectileBackend : Tuning->ProjectileBackend;
+		AOmegaProjectile* SpawnedProjectile = nullptr;
+
+		if ((Backend == EProjectileBackend::PB_Simulated) && BulletManager && projectile)
 		{
-			if ((projectile != SecondaryProjectileClass) || (projectile == nullptr)) FireHitscan(AimTarget);
+			BulletManager->Fire(projectile, SpawnLocation, AimRotation, OwningPlayerRef);
+			return;
+		}
+
+		if ((Backend == EProjectileBackend::PB_Pooled) && ProjectilePool)
+		{
+			EProjectilePoolResult PoolResult;
+			SpawnedProjectile = ProjectilePool->Acquire(projectile, SpawnLocation, AimRotation, PoolResult);
+
+			// an exhausted pool drops the shot, only geometry in the way falls through to the hitscan below
+			if (PoolResult == EProjectilePoolResult::Exhausted) return;
+		}
+		else SpawnedProjectile = World->SpawnActor<AOmegaProjectile>(projectile, SpawnLocation, AimRotation, ActorSpawnParams);
+
+		if (SpawnedProjectile) SpawnedProjectile->Instigator = OwningPlayerRef;
+		else
+		{
+			if ((projectile != Tuning->SecondaryProjectileClass) || (projectile == nullptr)) FireHitscan(AimTarget);
 			else
 			{
 				// call secondary projectile class > 'failed to spawn' behavior
@@ -158,56 +491,166 @@ void AOmegaGunBase::FireProjectile(TSubclassOf<AOmegaProjectile> projectile, con
 
 void AOmegaGunBase::FireHitscan(const FVector & AimTarg)
 {
+	// pellet shots are counted under their own stat, not this one as well
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
+	if (Tuning->PelletCount > 1)
+	{
+		FirePelletHitscan(AimTarg);
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_OmegaFireHitscan);
+
 	UWorld* const World = GetWorld();
 	if (World)
 	{
 		//const FName HitscanTrace = "Trace Tag";
 		//World->DebugDrawTraceTag = HitscanTrace;
 
-		FHitResult* hit = new FHitResult();
+		FHitResult hit;
 		FCollisionQueryParams params = FCollisionQueryParams(FName(TEXT("collision query")), false, this);
 		params.AddIgnoredActor(OwningPlayerRef);
 		//params.TraceTag = "Trace Tag";
 
-		FVector MuzzleLocation = GunSkeleton->GetSocketLocation("Muzzle");
-		FRotator MuzzleRotation = UGameplayStatics::GetPlayerController(this, 0)->GetControlRotation();
+		FVector MuzzleLocation = GetScheduledMuzzleLocation();
+		FRotator MuzzleRotation = OwningPlayerRef->GetControlRotation();
 
-		if (World->LineTraceSingleByObjectType(*hit, MuzzleLocation, AimTarg + HitscanRangeBuffer * MuzzleRotation.Vector(), FCollisionObjectQueryParams::AllObjects, params))
+		const bool bDrawDebug = CVarOmegaDrawHitscan.GetValueOnGameThread() != 0;
+
+		if (TraceHitscanRay(World, MuzzleLocation, AimTarg + Tuning->HitscanRangeBuffer * MuzzleRotation.Vector(), params, hit))
 		{
-			DrawDebugLine(World, MuzzleLocation, hit->Location, FColor::Blue, false, 0.25f, 0, 5.f);
+			if (bDrawDebug) DrawDebugLine(World, MuzzleLocation, hit.Location, FColor::Blue, false, 0.25f, 0, 5.f);
 
-			if ((hit->GetActor() != NULL) && (hit->GetComponent() != NULL))
+			// predicted shots on clients stop at the trace, the server applies the hit
+			if ((hit.GetActor() != NULL) && (hit.GetComponent() != NULL) && OmegaNet::IsGameplayAuthority(World) && DamageQueue)
 			{
-				if (hit->GetComponent()->IsSimulatingPhysics())
+				FOmegaTelemetry::RecordHit(OwningPlayerRef, this, hit.GetActor(), hit.Location);
+
+				if (hit.GetComponent()->IsSimulatingPhysics())
 				{
-					hit->GetComponent()->AddImpulseAtLocation((AimTarg - MuzzleLocation).GetSafeNormal() * DefaultHitscanForce, GetActorLocation());
+					DamageQueue->AddImpulse(hit.GetComponent(), (AimTarg - MuzzleLocation).GetSafeNormal() * Tuning->DefaultHitscanForce, GetActorLocation());
 				}
 
-				AOmegaCharacter* omegaActor = Cast<AOmegaCharacter>(hit->GetActor());
+				AOmegaCharacter* omegaActor = Cast<AOmegaCharacter>(hit.GetActor());
 
 				if (omegaActor)
 				{
-					omegaActor->ReceiveDamage(DefaultHitscanDamage);
+					DamageQueue->AddDamage(omegaActor, Tuning->DefaultHitscanDamage);
 				}
 			}
 		}
-		else
+		else if (bDrawDebug)
 		{
 			DrawDebugLine(World, MuzzleLocation, AimTarg, FColor::Blue, false, 0.25f, 0, 5.f);
 		}
 	}
 }
 
+bool AOmegaGunBase::TraceHitscanRay(UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params, FHitResult& OutHit) const
+{
+	const float RewindTime = GetLagCompensationRewindTime();
+	if (RewindTime > 0.f) return OmegaLagCompensation::LineTraceRewound(World, Start, End, RewindTime, OwningPlayerRef, Params, OutHit);
+
+	INC_DWORD_STAT(STAT_OmegaTracesIssued);
+	return World->LineTraceSingleByObjectType(OutHit, Start, End, OmegaObjectQueries::Combat, Params);
+}
+
+float AOmegaGunBase::GetLagCompensationRewindTime() const
+{
+	if (!HasAuthority() || !OwningPlayerRef || OwningPlayerRef->IsLocallyControlled() || !OwningPlayerRef->PlayerState) return 0.f;
+
+	const ENetMode NetMode = GetNetMode();
+	if ((NetMode != NM_DedicatedServer) && (NetMode != NM_ListenServer)) return 0.f;
+
+	// half the round trip puts the shot back at the time the client saw it
+	return FMath::Min(OwningPlayerRef->PlayerState->ExactPing * 0.0005f, GetArchetype()->MaxLagCompensationTime);
+}
+
+void AOmegaGunBase::FirePelletHitscan(const FVector& AimTarg)
+{
+	SCOPE_CYCLE_COUNTER(STAT_OmegaFirePellet);
+
+	UWorld* const World = GetWorld();
+	if (!World) return;
+
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
+	FCollisionQueryParams params = FCollisionQueryParams(FName(TEXT("collision query")), false, this);
+	params.AddIgnoredActor(OwningPlayerRef);
+
+	FVector MuzzleLocation = GetScheduledMuzzleLocation();
+	FRotator MuzzleRotation = OwningPlayerRef->GetControlRotation();
+	FVector ShotVector = (AimTarg + Tuning->HitscanRangeBuffer * MuzzleRotation.Vector()) - MuzzleLocation;
+	float ShotRange = ShotVector.Size();
+	FVector ShotDirection = ShotVector.GetSafeNormal();
+	float SpreadHalfAngle = FMath::DegreesToRadians(Tuning->PelletSpreadAngle);
+
+	// hits go through the damage queue, which totals them per target - one damage call and one impulse for the whole shot
+	AOmegaDamageQueue* const Queue = (OmegaNet::IsGameplayAuthority(World)) ? DamageQueue : nullptr;
+	const bool bDrawDebug = CVarOmegaDrawHitscan.GetValueOnGameThread() != 0;
+
+	// trace every pellet in one pass before applying any of the results
+	for (int32 pellet = 0; pellet < Tuning->PelletCount; pellet++)
+	{
+		FVector PelletDirection = FMath::VRandCone(ShotDirection, SpreadHalfAngle);
+		FVector PelletEnd = MuzzleLocation + PelletDirection * ShotRange;
+		FHitResult hit;
+
+		if (!TraceHitscanRay(World, MuzzleLocation, PelletEnd, params, hit))
+		{
+			if (bDrawDebug) DrawDebugLine(World, MuzzleLocation, PelletEnd, FColor::Blue, false, 0.25f, 0, 2.f);
+			continue;
+		}
+
+		if (bDrawDebug) DrawDebugLine(World, MuzzleLocation, hit.Location, FColor::Blue, false, 0.25f, 0, 2.f);
+
+		// predicted shots on clients stop at the traces, the server applies the hits
+		if ((hit.GetActor() == NULL) || (hit.GetComponent() == NULL) || !Queue) continue;
+
+		FOmegaTelemetry::RecordHit(OwningPlayerRef, this, hit.GetActor(), hit.Location);
+
+		if (hit.GetComponent()->IsSimulatingPhysics())
+		{
+			Queue->AddImpulse(hit.GetComponent(), PelletDirection * Tuning->DefaultHitscanForce, GetActorLocation());
+		}
+
+		AOmegaCharacter* omegaActor = Cast<AOmegaCharacter>(hit.GetActor());
+
+		if (omegaActor)
+		{
+			Queue->AddDamage(omegaActor, Tuning->DefaultHitscanDamage);
+		}
+	}
+}
+
 void AOmegaGunBase::StartReload()
 {
-	if (currentGunAmmo == 0 || currentClipAmmo == clipAmmoMax) return;
+	RefreshAmmoState();
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
+	if (currentGunAmmo == 0 || currentClipAmmo >= Tuning->clipAmmoMax) return;
+
+	ReloadCompleteTime = GetWorld()->GetTimeSeconds() + Tuning->ReloadDuration;
+	bIsReloading = true;
+
+	// one timer per reload, for the ammo widget still reading ReloadTimer - only a local player's gun has one
+	if (IsHeldByLocalPlayer())
+	{
+		INC_DWORD_STAT(STAT_OmegaTimersArmed);
+		OmegaStats::TimersArmed++;
+		GetWorldTimerManager().SetTimer(ReloadTimer, Tuning->ReloadDuration, false);
+	}
 
-	GetWorldTimerManager().SetTimer(ReloadTimer, this, &AOmegaGunBase::Reload, 1.2f);
+	if (!HasAuthority()) ServerStartReload();
+	NotifyAmmoChanged();
 }
 
 bool AOmegaGunBase::PrimaryFire(const FVector& AimTarget)
 {	
-	if (ReloadTimer.IsValid() || !IsAbleToFire)
+	SCOPE_CYCLE_COUNTER(STAT_OmegaPrimaryFire);
+
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
+	RefreshAmmoState();
+
+	if (IsReloading() || !IsAbleToFire)
 	{
 		return false;
 	}
@@ -217,79 +660,261 @@ bool AOmegaGunBase::PrimaryFire(const FVector& AimTarget)
 		return false;
 	}
 
+	else if (IsPredictingShots() && (PendingShots.Num() >= Tuning->MaxPendingShots))
+	{
+		// too far ahead of the server, hold fire until it catches up
+		return false;
+	}
+
 	IsAbleToFire = false;
 
-	// try and fire a projectile
-	if (ProjectileClass) FireProjectile(ProjectileClass, AimTarget);
-	else FireHitscan(AimTarget); 
+	ExecutePrimaryShot(AimTarget);
+
+	if (IsPredictingShots())
+	{
+		PendingShots.Add({ NextShotSequence, GetWorld()->GetTimeSeconds() });
+		SET_DWORD_STAT(STAT_OmegaPredictedShotsPending, PendingShots.Num());
+		ServerFireShot(NextShotSequence++, AimTarget);
+		WakeTick();
+	}
 
 	// try and play the sound if specified
-	if (PrimaryFireSound) UGameplayStatics::PlaySoundAtLocation(this, PrimaryFireSound, GetActorLocation());
+	if (Tuning->PrimaryFireSound) UGameplayStatics::PlaySoundAtLocation(this, Tuning->PrimaryFireSound, GetActorLocation());
 
 	// check if reload necessary
 	if (--currentClipAmmo == 0) StartReload();
+	NotifyAmmoChanged();
 
 	if (TriggerConfig == EFireMode::FM_Single)
 	{
-		GetWorldTimerManager().SetTimer(PrimaryFireRateTimerHandle, this, &AOmegaGunBase::ResetIsAbleToFire, SingleFireRate);
+		ScheduleFireEvent(&AOmegaGunBase::ResetIsAbleToFire, Tuning->SingleFireRate);
 	}
 	else if (TriggerConfig == EFireMode::FM_Burst)
 	{
 		BurstRemaining = (IsBurstActive) ? BurstRemaining : BurstCount;
 		IsBurstActive = true;
-		GetWorldTimerManager().SetTimer(PrimaryFireRateTimerHandle, this, &AOmegaGunBase::BurstFire, AutoFireRate);
+		ScheduleFireEvent(&AOmegaGunBase::BurstFire, Tuning->AutoFireRate);
 	}
 	else
 	{
-		GetWorldTimerManager().SetTimer(PrimaryFireRateTimerHandle, this, &AOmegaGunBase::AutomaticFire, AutoFireRate);
+		ScheduleFireEvent(&AOmegaGunBase::AutomaticFire, Tuning->AutoFireRate);
 	}
 
 	return true;
 }
 
+void AOmegaGunBase::ExecutePrimaryShot(const FVector& AimTarget)
+{
+	// shots are recorded where they count, like hits
+	if (FOmegaTelemetry::IsRecording() && OmegaNet::IsGameplayAuthority(GetWorld()))
+	{
+		FOmegaTelemetry::RecordShot(OwningPlayerRef, this, (uint8)TriggerConfig, AutoFireCount, GetSpreadExtent(), AimTarget, GetScheduledMuzzleLocation());
+	}
+
+	// try and fire a projectile
+	TSubclassOf<AOmegaProjectile> ProjectileClass = GetArchetype()->ProjectileClass;
+	if (ProjectileClass) FireProjectile(ProjectileClass, AimTarget);
+	else FireHitscan(AimTarget);
+}
+
+bool AOmegaGunBase::IsPredictingShots() const
+{
+	return !HasAuthority() && OwningPlayerRef && OwningPlayerRef->IsLocallyControlled();
+}
+
+bool AOmegaGunBase::ServerFireShot_Validate(uint16 Sequence, FVector_NetQuantize AimTarget)
+{
+	return !AimTarget.ContainsNaN();
+}
+
+void AOmegaGunBase::ServerFireShot_Implementation(uint16 Sequence, FVector_NetQuantize AimTarget)
+{
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	// the client's reload started earlier than ours by the trip of the shot that emptied the clip, let it finish early
+	RefreshAmmoState();
+	if (IsReloading() && ((ReloadCompleteTime - Now) <= Tuning->MaxLagCompensationTime)) Reload();
+
+	const float MinShotInterval = FMath::Min(Tuning->SingleFireRate, Tuning->AutoFireRate) * Tuning->ServerFireRateTolerance;
+	const bool bTooSoon = (LastServerShotTime >= 0.f) && ((Now - LastServerShotTime) < MinShotInterval);
+
+	if (IsReloading() || (currentClipAmmo <= 0) || bTooSoon)
+	{
+		ClientShotRejected(Sequence, (uint16)FMath::Max(currentClipAmmo, 0), ServerReloadCount);
+		return;
+	}
+
+	LastServerShotTime = Now;
+	ExecutePrimaryShot(AimTarget);
+
+	if (--currentClipAmmo == 0) StartReload();
+	NotifyAmmoChanged();
+
+	ClientShotConfirmed(Sequence, (uint16)currentClipAmmo, ServerReloadCount);
+}
+
+void AOmegaGunBase::ClientShotConfirmed_Implementation(uint16 Sequence, uint16 ClipAmmo, uint8 Reloads)
+{
+	ResolvePendingShots(Sequence, ClipAmmo, Reloads);
+}
+
+void AOmegaGunBase::ClientShotRejected_Implementation(uint16 Sequence, uint16 ClipAmmo, uint8 Reloads)
+{
+	INC_DWORD_STAT(STAT_OmegaPredictedShotsRejected);
+	ResolvePendingShots(Sequence, ClipAmmo, Reloads);
+}
+
+void AOmegaGunBase::ResolvePendingShots(uint16 Sequence, uint16 ServerClipAmmo, uint8 ServerReloads)
+{
+	// answers can overtake each other (confirmations are unreliable), so anything up to this sequence is settled
+	while ((PendingShots.Num() > 0) && ((int16)(Sequence - PendingShots[0].Sequence) >= 0))
+	{
+		if (PendingShots[0].Sequence == Sequence)
+		{
+			SET_FLOAT_STAT(STAT_OmegaShotConfirmLatency, (GetWorld()->GetTimeSeconds() - PendingShots[0].SentTime) * 1000.f);
+		}
+		PendingShots.RemoveAt(0, 1, false);
+	}
+	SET_DWORD_STAT(STAT_OmegaPredictedShotsPending, PendingShots.Num());
+
+	ReconcileClipAmmo(ServerClipAmmo, ServerReloads);
+}
+
+void AOmegaGunBase::ReconcileClipAmmo(int32 ServerClipAmmo, uint8 ServerReloads)
+{
+	// our reload hasn't reached the server yet (or is still running here), its clip is from before the reload - keep ours
+	const int8 reloadsAhead = (int8)(ReloadCount - ServerReloads);
+	const bool bReloadingHere = IsReloading();
+	if ((reloadsAhead > 0) || ((reloadsAhead == 0) && bReloadingHere)) return;
+
+	// the server finished a reload we're still waiting on
+	if (bReloadingHere) EndReload();
+
+	ReloadCount = ServerReloads;
+	currentClipAmmo = FMath::Max(ServerClipAmmo - PendingShots.Num(), 0);
+	NotifyAmmoChanged();
+}
+
+void AOmegaGunBase::ExpirePendingShots()
+{
+	// a lost confirmation leaves its shot pending, give up on it after a second
+	const float ExpireTime = GetWorld()->GetTimeSeconds() - 1.f;
+	while ((PendingShots.Num() > 0) && (PendingShots[0].SentTime < ExpireTime))
+	{
+		PendingShots.RemoveAt(0, 1, false);
+	}
+	SET_DWORD_STAT(STAT_OmegaPredictedShotsPending, PendingShots.Num());
+}
+
+void AOmegaGunBase::OnRep_ClipAmmo(int32 PreviousClipAmmo)
+{
+	if (!IsPredictingShots())
+	{
+		NotifyAmmoChanged();
+		return;
+	}
+
+	const int32 ServerClipAmmo = currentClipAmmo;
+	currentClipAmmo = PreviousClipAmmo;
+	ReconcileClipAmmo(ServerClipAmmo, ServerReloadCount);
+}
+
+bool AOmegaGunBase::ServerStartReload_Validate()
+{
+	return true;
+}
+
+void AOmegaGunBase::ServerStartReload_Implementation()
+{
+	// an emptied clip already started the reload here
+	if (!IsReloading()) StartReload();
+}
+
 bool AOmegaGunBase::SecondaryFire(const FVector& AimTarget)
 {
+	const UOmegaWeaponArchetype* Tuning = GetArchetype();
+	RefreshAmmoState();
+
 	if (currentSecondaryCharges == 0) return false;
 
-	// try and fire a projectile
-	if (SecondaryProjectileClass) FireProjectile(SecondaryProjectileClass, AimTarget);
+	// try and fire a projectile, a primary shot in its place is recorded as one
+	if (Tuning->SecondaryProjectileClass)
+	{
+		if (FOmegaTelemetry::IsRecording() && OmegaNet::IsGameplayAuthority(GetWorld()))
+		{
+			FOmegaTelemetry::RecordSecondaryShot(OwningPlayerRef, this, AimTarget, GetScheduledMuzzleLocation());
+		}
+		FireProjectile(Tuning->SecondaryProjectileClass, AimTarget);
+	}
 	else if (currentClipAmmo == 0) return false;
 	else SecondaryPrimaryFire(AimTarget);
 
 	// try and play the sound if specified
-	if (SecondaryFireSound) UGameplayStatics::PlaySoundAtLocation(this, SecondaryFireSound, GetActorLocation());
+	if (Tuning->SecondaryFireSound) UGameplayStatics::PlaySoundAtLocation(this, Tuning->SecondaryFireSound, GetActorLocation());
 
 	UWorld* w = GetWorld();
 	if (w)
 	{
-		FTimerHandle* newestChargeTimer = new FTimerHandle();
-		SecondaryChargeTimers.Add(newestChargeTimer);
-
-		w->GetTimerManager().SetTimer(*newestChargeTimer, this, &AOmegaGunBase::AddCharge, SecondaryRechargeTimer);
+		// spent charges recharge in parallel, so ready times are pushed in increasing order
+		ChargeReadyTimes[(ChargeReadyHead + ChargeReadyCount) % MaxSecondaryCharges] = w->GetTimeSeconds() + Tuning->SecondaryRechargeTimer;
+		ChargeReadyCount = FMath::Min(ChargeReadyCount + 1, MaxSecondaryCharges);
 		currentSecondaryCharges--;
+		NotifyAmmoChanged();
 	}
 
 	return true;
 }
 
+float AOmegaGunBase::GetTimeUntilNextCharge() const
+{
+	if (ChargeReadyCount == 0) return 0.f;
+	return FMath::Max(ChargeReadyTimes[ChargeReadyHead] - GetWorld()->GetTimeSeconds(), 0.f);
+}
+
 FTimerHandle AOmegaGunBase::GetOldestSecondaryChargeTimer() const
 {
-	if (SecondaryChargeTimers.Num() == 0) return *(new FTimerHandle());
-	return *SecondaryChargeTimers[0];
+	FTimerManager& TimerManager = GetWorldTimerManager();
+	const float Remaining = GetTimeUntilNextCharge();
+
+	// the ammo widget polling this only exists for a local player, nobody else gets a timer
+	if ((Remaining <= 0.f) || !IsHeldByLocalPlayer())
+	{
+		TimerManager.ClearTimer(OldestChargeTimer);
+		return OldestChargeTimer;
+	}
+
+	// re-armed only when the oldest charge has changed since the last call, elapsed then reads against the full recharge
+	if (!TimerManager.IsTimerActive(OldestChargeTimer) || !FMath::IsNearlyEqual(TimerManager.GetTimerRemaining(OldestChargeTimer), Remaining, 0.01f))
+	{
+		INC_DWORD_STAT(STAT_OmegaTimersArmed);
+		OmegaStats::TimersArmed++;
+		TimerManager.SetTimer(OldestChargeTimer, FMath::Max(GetArchetype()->SecondaryRechargeTimer, Remaining), false, Remaining);
+	}
+
+	return OldestChargeTimer;
 }
 
 void AOmegaGunBase::AddCharge()
 {
-	if (currentSecondaryCharges >= clipSecondaryChargeMax) return;
+	// the oldest recharging charge is the one coming back
+	if (ChargeReadyCount > 0)
+	{
+		ChargeReadyHead = (ChargeReadyHead + 1) % MaxSecondaryCharges;
+		ChargeReadyCount--;
+	}
+
+	if (currentSecondaryCharges >= GetArchetype()->clipSecondaryChargeMax) return;
 
 	currentSecondaryCharges++;
-	SecondaryChargeTimers[0]->Invalidate();
-	SecondaryChargeTimers.RemoveAt(0);
+	NotifyAmmoChanged();
 }
 
 bool AOmegaGunBase::SecondaryPrimaryFire(const FVector & AimTarget)
 {
-	if (ReloadTimer.IsValid())
+	RefreshAmmoState();
+
+	if (IsReloading())
 	{
 		return false;
 	}
@@ -299,12 +924,11 @@ bool AOmegaGunBase::SecondaryPrimaryFire(const FVector & AimTarget)
 		return false;
 	}
 
-	// try and fire a projectile
-	if (ProjectileClass) FireProjectile(ProjectileClass, AimTarget);
-	else FireHitscan(AimTarget);
+	ExecutePrimaryShot(AimTarget);
 
 	// check if reload necessary
 	if (--currentClipAmmo == 0) StartReload();
+	NotifyAmmoChanged();
 
 	return true;
 }
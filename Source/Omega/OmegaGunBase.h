@@ -4,32 +4,51 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Engine/NetSerialization.h"
+#include "OmegaWeaponArchetype.h"
 #include "OmegaGunBase.generated.h"
 
-UENUM(BlueprintType)
-enum class EFireMode : uint8
-{
-	FM_Single	UMETA(DisplayName = "Semi-automatic"),
-	FM_Burst	UMETA(DisplayName = "Burst-fire"),
-	FM_Auto		UMETA(DisplayName = "Automatic")
-};
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOmegaAmmoChangedSignature, int32, ClipAmmo, int32, ReserveAmmo);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOmegaChargeCountChangedSignature, int32, Charges, int32, MaxCharges);
 
 UCLASS()
 class OMEGA_API AOmegaGunBase : public AActor
 {
 	GENERATED_BODY()
 
+	// drives the fire schedule and shot paths directly to time them
+	friend class AOmegaBenchmark;
+
 	virtual void Reload();
 	virtual void FireProjectile(TSubclassOf<class AOmegaProjectile> projectile, const FVector& AimTarget);
 	virtual void FireHitscan(const FVector& AimTarg);
+	virtual void FirePelletHitscan(const FVector& AimTarg);
 
-	TArray<FTimerHandle*> SecondaryChargeTimers;
+	/**
+	 * Charges and reload run off timestamps rather than timers: each spent charge records when it will be back, in a ring
+	 * ordered oldest first (the archetype's clipSecondaryChargeMax is clamped to 10), and a reload records when it completes.
+	 * RefreshAmmoState settles whatever has come due, so nothing waits on the timer manager - the deprecated ReloadTimer
+	 * and GetOldestSecondaryChargeTimer handles only mirror these for older blueprints, and only on a local player's gun.
+	 */
+	static constexpr int32 MaxSecondaryCharges = 10;
+	float ChargeReadyTimes[MaxSecondaryCharges];
+	int32 ChargeReadyHead = 0;
+	int32 ChargeReadyCount = 0;
+	float ReloadCompleteTime = -1.f;
+	// ends a completed or superseded reload
+	void EndReload();
+	// backs GetOldestSecondaryChargeTimer
+	mutable FTimerHandle OldestChargeTimer;
+	// the deprecated timer mirrors are only armed for a locally controlled player's gun, the only one with an ammo widget
+	bool IsHeldByLocalPlayer() const;
 	
 public:	
 	// Sets default values for this actor's properties
 	AOmegaGunBase();
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	virtual void PostLoad() override;
 
 	UFUNCTION(BlueprintCallable, Category = "Gun")
 	void StartReload();
@@ -42,51 +61,60 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Gun")
 	virtual bool SecondaryPrimaryFire(const FVector& AimTarget);
 
+	/**
+	 * Tuning shared by every gun of this kind. Left unset, the gun runs on the archetype class defaults. Swapping it
+	 * (fire mode changes and the like) keeps ammo, clamped to the new maxima.
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, ReplicatedUsing = OnRep_Archetype, Category = "Weapon Configuration")
+	UOmegaWeaponArchetype* Archetype = nullptr;
+
+	const UOmegaWeaponArchetype* GetArchetype() const { return (Archetype) ? Archetype : GetDefault<UOmegaWeaponArchetype>(); }
+
+	/** on the owning client the swap applies right away and is sent on to the server */
+	UFUNCTION(BlueprintCallable, Category = "Weapon Configuration")
+	void SetArchetype(UOmegaWeaponArchetype* NewArchetype);
+
+	/** archetypes an owning client may swap this gun to, besides the one it was authored with */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Configuration")
+	TArray<UOmegaWeaponArchetype*> AllowedArchetypes;
+
+	/** fire mode in use, seeded from the archetype whenever it's applied - the owner's blueprint switches it */
+	UPROPERTY(BlueprintReadWrite, Category = "Weapon Configuration")
+	EFireMode TriggerConfig = EFireMode::FM_Single;
+	UPROPERTY(BlueprintReadWrite, Category = "Weapon Configuration")
+	int32 BurstCount = 2;
+
 	/* these functions and variables handle ammo and reloading */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo", meta = (ClampMin = "0.0", ClampMax = "3000.0"))
-	int32 totalAmmoMax = 100;
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo", meta = (ClampMin = "0.0", ClampMax = "3000.0"))
-	int32 clipAmmoMax = 25;
-	UPROPERTY(BlueprintReadWrite, Category = "Ammo")
+	UPROPERTY(ReplicatedUsing = OnRep_ClipAmmo, BlueprintReadWrite, Category = "Ammo")
 	int32 currentClipAmmo;
-	UPROPERTY(BlueprintReadWrite, Category = "Ammo")
+	UPROPERTY(ReplicatedUsing = OnRep_AmmoState, BlueprintReadWrite, Category = "Ammo")
 	int32 currentGunAmmo;
-	UPROPERTY(BlueprintReadOnly, Category = "Ammo")
-	FTimerHandle ReloadTimer;
+	/** replicated reload flag for display, the reload itself is timed where it was started */
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Ammo")
+	bool bIsReloading = false;
+
+	UFUNCTION(BlueprintCallable, Category = "Ammo")
+	bool IsReloading() const { return ReloadCompleteTime >= 0.f; }
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo", meta = (ClampMin = "0.0", ClampMax = "10.0"))
-	int32 clipSecondaryChargeMax = 2;
-	UPROPERTY(BlueprintReadWrite, Category = "Ammo")
+	/** completes a due reload and returns recharged charges - cheap when nothing is due, the owner calls it every tick */
+	void RefreshAmmoState();
+
+	UPROPERTY(ReplicatedUsing = OnRep_AmmoState, BlueprintReadWrite, Category = "Ammo")
 	int32 currentSecondaryCharges;
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo")
-	float SecondaryRechargeTimer = 3.f;
 
+	/** seconds until the next spent charge is back, zero when none are recharging */
 	UFUNCTION(BlueprintCallable, Category = "Gun")
-	FTimerHandle GetOldestSecondaryChargeTimer() const;
+	float GetTimeUntilNextCharge() const;
 
-	/** Projectile class to spawn */
-	UPROPERTY(EditDefaultsOnly, Category = Projectile)
-	TSubclassOf<class AOmegaProjectile> ProjectileClass;
-	/** Projectile class to spawn */
-	UPROPERTY(EditDefaultsOnly, Category = Projectile)
-	TSubclassOf<class AOmegaProjectile> SecondaryProjectileClass;
+	/** deprecated, a timer armed on demand that mirrors the oldest recharging charge - invalid when none are recharging or the gun isn't a local player's */
+	UFUNCTION(BlueprintCallable, Category = "Gun", meta = (DeprecatedFunction, DeprecationMessage = "Charges no longer run on timers, use GetTimeUntilNextCharge."))
+	FTimerHandle GetOldestSecondaryChargeTimer() const;
 
-	/** Sound to play each time we fire */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-	class USoundBase* PrimaryFireSound;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Gameplay)
-	class USoundBase* SecondaryFireSound;
+	/** deprecated, mirrors the reload for blueprints that still read it, on a local player's gun only - nothing is bound to it */
+	UPROPERTY(BlueprintReadOnly, Category = "Ammo", meta = (DeprecatedProperty, DeprecationMessage = "Reloads no longer run on a timer, use IsReloading."))
+	FTimerHandle ReloadTimer;
 
 	/* these variables and functions handle the trigger configuration settings for the weapon */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Weapon Configuration")
-	EFireMode TriggerConfig = EFireMode::FM_Single;
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Configuration")
-	float SingleFireRate = 0.5f;
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Configuration")
-	float AutoFireRate = 0.1f;
-	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "Weapon Configuration")
-	int32 BurstCount = 2;
 	int32 BurstRemaining = 0;
 	bool IsAbleToFire = true;
 	bool IsTriggerHeld = false;
@@ -102,17 +130,25 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Gun")
 	void SetOwningPlayerRef(class AOmegaCharacter* OwningPlayer);
 
-	UFUNCTION(BlueprintCallable, Category = "Gun")
-	FTimerHandle GetPrimaryFireTimerHandle();
+	/**
+	 * call after changing clip, reserve or charges - flushes them to the owning client without waiting for the next
+	 * (infrequent) net update, and fires OnAmmoChanged/OnChargeCountChanged for whichever actually changed
+	 */
+	void NotifyAmmoChanged();
 
-	/* these variables and functions handle the recoil/spread behavior for the weapon */
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Spread")
-	float BurstFireSpread = 5.f;
+	/** change notifications for the ammo widgets, fired on the server and on the owning client */
+	UPROPERTY(BlueprintAssignable, Category = "Ammo")
+	FOmegaAmmoChangedSignature OnAmmoChanged;
+	UPROPERTY(BlueprintAssignable, Category = "Ammo")
+	FOmegaChargeCountChangedSignature OnChargeCountChanged;
+
+	/** true while a shot, burst or fire rate cooldown is still in progress */
+	UFUNCTION(BlueprintCallable, Category = "Gun")
+	bool IsFireCycleActive() const;
 
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Spread")
-	int AutoFireSpreadThreshold = 3;
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Spread")
-	float MaxAutoFireSpread = 30.f;
+	/** how far, in world units at the aim location, the current burst/auto fire pushes shots off the aim point */
+	UFUNCTION(BlueprintCallable, Category = "Weapon Spread")
+	float GetSpreadExtent() const;
 
 protected:
 	// Called when the game starts or when spawned
@@ -121,16 +157,137 @@ protected:
 	UPROPERTY(VisibleDefaultsOnly, Category = "Appearance")
 	class USkeletalMeshComponent* GunSkeleton;
 
-	UPROPERTY(EditDefaultsOnly, Category = "Gun")
-	float DefaultHitscanDamage = 10.f;
-	UPROPERTY(EditDefaultsOnly, Category = "Gun")
-	float DefaultHitscanForce = 100000.f;
-	UPROPERTY(EditDefaultsOnly, Category = "Gun")
-	float HitscanRangeBuffer = 50.f;
-
 private:
 	AOmegaCharacter* OwningPlayerRef = nullptr;
-	FTimerHandle PrimaryFireRateTimerHandle;
+
+	/**
+	 * Predicted firing. The owning client fires immediately - ammo, sound, montage and a cosmetic trace - and sends
+	 * the shot to the server with a sequence number. The server validates it, runs the real shot and answers with its
+	 * clip for that sequence. The client's clip is always the server's clip minus the shots still awaiting an answer,
+	 * so a rejected shot rolls back by simply dropping out of the pending list.
+	 */
+	void ExecutePrimaryShot(const FVector& AimTarget);
+	bool IsPredictingShots() const;
+	void ResolvePendingShots(uint16 Sequence, uint16 ServerClipAmmo, uint8 ServerReloads);
+	void ReconcileClipAmmo(int32 ServerClipAmmo, uint8 ServerReloads);
+	void ExpirePendingShots();
+
+	struct FPendingShot
+	{
+		uint16 Sequence;
+		float SentTime;
+	};
+	TArray<FPendingShot, TInlineAllocator<16>> PendingShots;
+	uint16 NextShotSequence = 0;
+	float LastServerShotTime = -1.f;
+
+	// reloads completed on this machine, and on the server - a clip from the other side of a reload isn't comparable
+	uint8 ReloadCount = 0;
+	UPROPERTY(Replicated)
+	uint8 ServerReloadCount = 0;
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerFireShot(uint16 Sequence, FVector_NetQuantize AimTarget);
+	UFUNCTION(Client, Unreliable)
+	void ClientShotConfirmed(uint16 Sequence, uint16 ClipAmmo, uint8 Reloads);
+	UFUNCTION(Client, Reliable)
+	void ClientShotRejected(uint16 Sequence, uint16 ClipAmmo, uint8 Reloads);
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerStartReload();
+	UFUNCTION()
+	void OnRep_ClipAmmo(int32 PreviousClipAmmo);
+	UFUNCTION()
+	void OnRep_AmmoState();
+	UFUNCTION()
+	void OnRep_Archetype();
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerSetArchetype(UOmegaWeaponArchetype* NewArchetype);
+
+	// clamps ammo to the current archetype, seeds the fire mode and readies whatever its projectile backends need
+	void ApplyArchetype();
+
+	/**
+	 * Tuning from before archetypes, only still here so guns saved with it load. PostLoad moves anything that differs
+	 * from the archetype defaults into an archetype of the gun's own, resaving the gun makes that permanent.
+	 */
+	UPROPERTY()
+	int32 totalAmmoMax_DEPRECATED = 100;
+	UPROPERTY()
+	int32 clipAmmoMax_DEPRECATED = 25;
+	UPROPERTY()
+	int32 clipSecondaryChargeMax_DEPRECATED = 2;
+	UPROPERTY()
+	float SecondaryRechargeTimer_DEPRECATED = 3.f;
+	UPROPERTY()
+	TSubclassOf<class AOmegaProjectile> ProjectileClass_DEPRECATED;
+	UPROPERTY()
+	TSubclassOf<class AOmegaProjectile> SecondaryProjectileClass_DEPRECATED;
+	UPROPERTY()
+	class USoundBase* PrimaryFireSound_DEPRECATED = nullptr;
+	UPROPERTY()
+	class USoundBase* SecondaryFireSound_DEPRECATED = nullptr;
+	UPROPERTY()
+	float SingleFireRate_DEPRECATED = 0.5f;
+	UPROPERTY()
+	float AutoFireRate_DEPRECATED = 0.1f;
+	UPROPERTY()
+	float BurstFireSpread_DEPRECATED = 5.f;
+	UPROPERTY()
+	int32 AutoFireSpreadThreshold_DEPRECATED = 3;
+	UPROPERTY()
+	float MaxAutoFireSpread_DEPRECATED = 30.f;
+	UPROPERTY()
+	float DefaultHitscanDamage_DEPRECATED = 10.f;
+	UPROPERTY()
+	float DefaultHitscanForce_DEPRECATED = 100000.f;
+	UPROPERTY()
+	float HitscanRangeBuffer_DEPRECATED = 50.f;
+
+	// moves the deprecated tuning into an archetype, when there's any to move
+	void MigrateDeprecatedTuning();
+
+	// last values the ammo delegates went out with
+	int32 NotifiedClipAmmo = INDEX_NONE;
+	int32 NotifiedGunAmmo = INDEX_NONE;
+	int32 NotifiedSecondaryCharges = INDEX_NONE;
+
+	// traces a single hitscan ray, rewound to the owner's estimated client time when the server fires for a remote player
+	bool TraceHitscanRay(UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params, FHitResult& OutHit) const;
+	float GetLagCompensationRewindTime() const;
+
+	UPROPERTY()
+	class AOmegaProjectilePool* ProjectilePool = nullptr;
+	UPROPERTY()
+	class AOmegaBulletManager* BulletManager = nullptr;
+	UPROPERTY()
+	class AOmegaDamageQueue* DamageQueue = nullptr;
+
+	/**
+	 * Fire rate scheduling. Rather than re-arming a timer per shot, the weapon keeps the single pending fire event
+	 * and counts it down in Tick, emitting every event that came due during the frame. Each emitted shot
+	 * interpolates aim and muzzle location to its point within the frame, so the fire rate doesn't depend on the frame rate.
+	 */
+	typedef void (AOmegaGunBase::*FFireEvent)();
+	void ScheduleFireEvent(FFireEvent Event, float Delay);
+	// enables the weapon's tick if it was asleep, returns whether it was
+	bool WakeTick();
+	// set while something other than the world ticks the weapon (the benchmark, timing it), WakeTick leaves it asleep
+	bool bTickedExternally = false;
+	void AdvanceFireSchedule(float DeltaTime);
+	void CaptureFireScheduleFrame();
+	FVector GetScheduledAimLocation() const;
+	FVector GetScheduledMuzzleLocation() const;
+
+	FFireEvent PendingFireEvent = nullptr;
+	float FireEventDelay = 0.f;
+	float FireScheduleCarry = 0.f;
+	float FireScheduleAlpha = 1.f;
+	bool bIsAdvancingFireSchedule = false;
+	FVector PreviousAimLocation = FVector::ZeroVector;
+	FVector PreviousMuzzleLocation = FVector::ZeroVector;
+
+	// lower bound on fire event spacing, keeps a zero fire rate from spinning the schedule forever
+	static constexpr float MinFireEventInterval = 0.001f;
 
 	int AutoFireCount = 0;
 };
@@ -6,12 +6,39 @@
 #include "TextureResource.h"
 #include "CanvasItem.h"
 #include "UObject/ConstructorHelpers.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "OmegaCharacter.h"
+#include "OmegaGunBase.h"
 
 AOmegaHUD::AOmegaHUD()
 {
 	// Set the crosshair texture
 	static ConstructorHelpers::FObjectFinder<UTexture2D> CrosshairTexObj(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair"));
 	CrosshairTex = CrosshairTexObj.Object;
+
+	// until there's a dedicated atlas every state uses the whole crosshair, told apart by tint
+	const FLinearColor stateColors[] =
+	{
+		FLinearColor::White,					// VTS_DEFAULT
+		FLinearColor(0.2f, 0.5f, 1.f),			// VTS_COVER
+		FLinearColor(1.f, 0.85f, 0.1f),			// VTS_AMMO
+		FLinearColor(0.2f, 1.f, 0.3f),			// VTS_HEALTH
+		FLinearColor(1.f, 0.5f, 0.f),			// VTS_OBJECT
+		FLinearColor(0.3f, 1.f, 1.f),			// VTS_NPC
+		FLinearColor(1.f, 0.15f, 0.15f)			// VTS_STEALTH
+	};
+
+	for (const FLinearColor& color : stateColors)
+	{
+		FOmegaReticleIcon& icon = ReticleIcons[ReticleIcons.AddDefaulted()];
+		icon.Color = color;
+	}
+
+	// a few texels from the middle of the crosshair
+	SpreadTick.UV0 = FVector2D(0.45f, 0.45f);
+	SpreadTick.UV1 = FVector2D(0.55f, 0.55f);
+	SpreadTick.Size = FVector2D(4.f, 4.f);
 }
 
 
@@ -19,17 +46,49 @@ void AOmegaHUD::DrawHUD()
 {
 	Super::DrawHUD();
 
-	// Draw very simple crosshair
+	if (bDrawNativeReticle) DrawNativeReticle();
+}
+
+void AOmegaHUD::DrawNativeReticle()
+{
+	AOmegaCharacter* character = Cast<AOmegaCharacter>(GetOwningPawn());
+	if (!character || !CrosshairTex || (ReticleIcons.Num() == 0)) return;
+
+	const FVector2D center(Canvas->ClipX * 0.5f, Canvas->ClipY * 0.5f);
+
+	const int32 stateIndex = (int32)character->GetReticleState();
+	const FOmegaReticleIcon& icon = ReticleIcons.IsValidIndex(stateIndex) ? ReticleIcons[stateIndex] : ReticleIcons[0];
+
+	FCanvasTileItem tileItem(center - icon.Size * 0.5f, CrosshairTex->Resource, icon.Size, icon.UV0, icon.UV1, icon.Color);
+	tileItem.BlendMode = SE_BLEND_Translucent;
+	Canvas->DrawItem(tileItem);
+
+	// the ticks are always drawn, with no spread they just sit at the minimum gap
+	static const FVector2D tickDirections[] = { FVector2D(0.f, -1.f), FVector2D(0.f, 1.f), FVector2D(-1.f, 0.f), FVector2D(1.f, 0.f) };
+	const float tickGap = SpreadTickMinGap + GetSpreadScreenExtent(character);
+
+	tileItem.Size = SpreadTick.Size;
+	tileItem.UV0 = SpreadTick.UV0;
+	tileItem.UV1 = SpreadTick.UV1;
+
+	for (const FVector2D& direction : tickDirections)
+	{
+		tileItem.Position = center + direction * tickGap - SpreadTick.Size * 0.5f;
+		Canvas->DrawItem(tileItem);
+	}
+}
+
+float AOmegaHUD::GetSpreadScreenExtent(AOmegaCharacter* Character) const
+{
+	const AOmegaGunBase* weapon = Character->GetCurrentWeapon();
+	if (!weapon || !PlayerOwner || !PlayerOwner->PlayerCameraManager) return 0.f;
 
-	//// find center of the Canvas
-	//const FVector2D Center(Canvas->ClipX * 0.5f, Canvas->ClipY * 0.5f);
+	const float spread = weapon->GetSpreadExtent();
+	if (spread <= 0.f) return 0.f;
 
-	//// offset by half the texture's dimensions so that the center of the texture aligns with the center of the Canvas
-	//const FVector2D CrosshairDrawPosition( (Center.X),
-	//									   (Center.Y + 20.0f));
+	const APlayerCameraManager* cameraManager = PlayerOwner->PlayerCameraManager;
+	const float aimDistance = FMath::Max(FVector::Dist(cameraManager->GetCameraLocation(), Character->GetAimLocation()), 1.f);
+	const float halfFov = FMath::DegreesToRadians(cameraManager->GetFOVAngle() * 0.5f);
 
-	//// draw the crosshair
-	//FCanvasTileItem TileItem( CrosshairDrawPosition, CrosshairTex->Resource, FLinearColor::White);
-	//TileItem.BlendMode = SE_BLEND_Translucent;
-	//Canvas->DrawItem( TileItem );
+	return (spread / aimDistance) / FMath::Tan(halfFov) * Canvas->ClipX * 0.5f;
 }
@@ -6,7 +6,23 @@
 #include "GameFramework/HUD.h"
 #include "OmegaHUD.generated.h"
 
-UCLASS()
+/** one reticle image: a region of the reticle atlas, its on-screen size and tint */
+USTRUCT()
+struct FOmegaReticleIcon
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditDefaultsOnly, Category = "Reticle")
+	FVector2D UV0 = FVector2D(0.f, 0.f);
+	UPROPERTY(EditDefaultsOnly, Category = "Reticle")
+	FVector2D UV1 = FVector2D(1.f, 1.f);
+	UPROPERTY(EditDefaultsOnly, Category = "Reticle")
+	FVector2D Size = FVector2D(16.f, 16.f);
+	UPROPERTY(EditDefaultsOnly, Category = "Reticle")
+	FLinearColor Color = FLinearColor::White;
+};
+
+UCLASS(config=Game)
 class AOmegaHUD : public AHUD
 {
 	GENERATED_BODY()
@@ -17,9 +33,30 @@ public:
 	/** Primary draw call for the HUD */
 	virtual void DrawHUD() override;
 
+	/**
+	 * Draws the reticle natively instead of through the Crosshair widget: the icon for the current reticle state plus
+	 * four spread ticks, always five tiles from the one atlas so the canvas batches them into a single draw.
+	 */
+	UPROPERTY(EditDefaultsOnly, config, Category = "Reticle")
+	bool bDrawNativeReticle = false;
+
+	/** reticle image per EViewTargetState, indexed by the enum value */
+	UPROPERTY(EditDefaultsOnly, config, Category = "Reticle")
+	TArray<FOmegaReticleIcon> ReticleIcons;
+
+	/** atlas region and size of a spread tick, tinted like the current icon */
+	UPROPERTY(EditDefaultsOnly, config, Category = "Reticle")
+	FOmegaReticleIcon SpreadTick;
+	/** distance, in pixels, of the spread ticks from the screen center with no spread */
+	UPROPERTY(EditDefaultsOnly, config, Category = "Reticle")
+	float SpreadTickMinGap = 12.f;
+
 private:
-	/** Crosshair asset pointer */
+	/** Crosshair asset pointer, doubles as the default reticle atlas */
 	class UTexture2D* CrosshairTex;
 
+	void DrawNativeReticle();
+	// projects the weapon's spread at the aim location to pixels from the screen center
+	float GetSpreadScreenExtent(class AOmegaCharacter* Character) const;
 };
 
@@ -3,6 +3,11 @@
 #include "OmegaHealthPickup.h"
 #include "OmegaCharacter.h"
 
+AOmegaHealthPickup::AOmegaHealthPickup()
+{
+	ReticleTag = EViewTargetState::VTS_HEALTH;
+}
+
 void AOmegaHealthPickup::Pickup(AOmegaCharacter* ActingPlayer)
 {
 	ActingPlayer->RegainHealth(HealthValue);
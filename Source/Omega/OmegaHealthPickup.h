@@ -19,6 +19,8 @@ protected:
 	float HealthValue = 45.f;
 	
 public:
+	AOmegaHealthPickup();
+
 	UFUNCTION(BlueprintCallable, Category = "Pickup")
 	virtual void Pickup(class AOmegaCharacter* ActingPlayer) override;
 	
@@ -0,0 +1,459 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaInputReplay.h"
+#include "OmegaCharacter.h"
+#include "OmegaBenchmark.h"
+#include "Components/InputComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Misc/EngineVersion.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "RenderCore.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmegaInputReplay, Log, All);
+
+AOmegaInputReplay::AOmegaInputReplay()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+}
+
+FString AOmegaInputReplay::GetRecordingPath(const FString& RecordingName)
+{
+	return FPaths::Combine(FPaths::GameSavedDir(), TEXT("InputRecordings"), RecordingName + TEXT(".omir"));
+}
+
+AOmegaInputReplay* AOmegaInputReplay::StartRecording(UWorld* World, const FString& RecordingName)
+{
+	if (!World || RecordingName.IsEmpty()) return nullptr;
+	Stop(World);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AOmegaInputReplay* Recorder = World->SpawnActor<AOmegaInputReplay>(SpawnParams);
+	if (!Recorder) return nullptr;
+
+	Recorder->RecordingName = RecordingName;
+	Recorder->Seed = (int32)FPlatformTime::Cycles();
+	UE_LOG(LogOmegaInputReplay, Log, TEXT("recording %s once the player has a character"), *RecordingName);
+	return Recorder;
+}
+
+AOmegaInputReplay* AOmegaInputReplay::StartReplay(UWorld* World, const FString& RecordingName, bool bQuitWhenDone)
+{
+	if (!World || RecordingName.IsEmpty()) return nullptr;
+	Stop(World);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AOmegaInputReplay* Replay = World->SpawnActor<AOmegaInputReplay>(SpawnParams);
+	if (!Replay) return nullptr;
+
+	Replay->bReplaying = true;
+	Replay->bQuitWhenDone = bQuitWhenDone;
+	Replay->RecordingName = RecordingName;
+
+	const FString path = GetRecordingPath(RecordingName);
+	if (!FFileHelper::LoadFileToArray(Replay->Data, *path) || !Replay->ReadHeader())
+	{
+		UE_LOG(LogOmegaInputReplay, Error, TEXT("%s isn't a version %d input recording"), *path, (int32)FileVersion);
+
+		// nothing to replay, there's nothing to report either
+		Replay->bFinished = true;
+		Replay->Destroy();
+		if (bQuitWhenDone) FPlatformMisc::RequestExit(false);
+		return nullptr;
+	}
+
+	UE_LOG(LogOmegaInputReplay, Log, TEXT("replaying %s once the player has a character"), *RecordingName);
+	return Replay;
+}
+
+void AOmegaInputReplay::Stop(UWorld* World)
+{
+	if (!World) return;
+
+	// ending play saves the recording or reports the replay
+	for (TActorIterator<AOmegaInputReplay> It(World); It; ++It)
+	{
+		It->Destroy();
+	}
+}
+
+void AOmegaInputReplay::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (bFinished) return;
+
+	if (!Character)
+	{
+		TryBegin();
+		return;
+	}
+
+	if (Character->IsPendingKill())
+	{
+		UE_LOG(LogOmegaInputReplay, Warning, TEXT("the character went away, stopping %s"), *RecordingName);
+		Destroy();
+		return;
+	}
+
+	if (bReplaying) ReplayFrame();
+}
+
+bool AOmegaInputReplay::TryBegin()
+{
+	PlayerController = GetWorld()->GetFirstPlayerController();
+	AOmegaCharacter* character = (PlayerController) ? Cast<AOmegaCharacter>(PlayerController->GetPawn()) : nullptr;
+
+	// the input component only exists once the pawn is possessed
+	if (!character || !character->InputComponent) return false;
+
+	Character = character;
+
+	// runs ahead of the controller's input processing and the character, like real input
+	PlayerController->AddTickPrerequisiteActor(this);
+	Character->AddTickPrerequisiteActor(this);
+
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+	LockTimestep();
+
+	if (bReplaying) BeginReplay();
+	else BeginRecording();
+
+	return true;
+}
+
+void AOmegaInputReplay::LockTimestep()
+{
+	bPreviousUseFixedTimeStep = FApp::UseFixedTimeStep();
+	PreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+	bTimestepLocked = true;
+
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FMath::Max(FixedFrameRate, 1.f));
+}
+
+void AOmegaInputReplay::RestoreTimestep()
+{
+	if (!bTimestepLocked) return;
+	bTimestepLocked = false;
+
+	FApp::SetUseFixedTimeStep(bPreviousUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(PreviousFixedDeltaTime);
+}
+
+void AOmegaInputReplay::BeginRecording()
+{
+	const TArray<FOmegaAxisInput>& axes = AOmegaCharacter::GetAxisInputs();
+	const TArray<FOmegaActionInput>& actions = AOmegaCharacter::GetActionInputs();
+	NumAxes = axes.Num();
+	LastAxisValues.Init(0.f, NumAxes);
+
+	// the rest of this frame's input has partly been processed already, frame 0 is the next one
+	StartFrame = GFrameCounter + 1;
+
+	FMemoryWriter writer(Data);
+	uint32 magic = FileMagic;
+	uint16 version = FileVersion;
+	FString mapName = GetWorld()->GetMapName();
+	TArray<FString> axisNames;
+	TArray<FString> actionNames;
+	for (const FOmegaAxisInput& input : axes) axisNames.Add(input.Name.ToString());
+	for (const FOmegaActionInput& input : actions) actionNames.Add(input.Name.ToString());
+	writer << magic << version << Seed << FixedFrameRate << mapName << axisNames << actionNames;
+
+	// bindings above the character's that see the same input and leave it for the character
+	RecorderInput = NewObject<UInputComponent>(this, TEXT("OmegaInputRecorder"));
+	RecorderInput->RegisterComponent();
+
+	for (int32 index = 0; index < axes.Num(); index++)
+	{
+		FInputAxisBinding binding(axes[index].Name);
+		binding.bConsumeInput = false;
+		binding.AxisDelegate.GetDelegateForManualSet().BindUObject(this, &AOmegaInputReplay::RecordAxis, index);
+		RecorderInput->AxisBindings.Add(binding);
+	}
+
+	for (int32 index = 0; index < actions.Num(); index++)
+	{
+		for (int32 released = 0; released < 2; released++)
+		{
+			if (!((released) ? actions[index].Released : actions[index].Pressed)) continue;
+
+			FInputActionBinding binding(actions[index].Name, (released) ? IE_Released : IE_Pressed);
+			binding.bConsumeInput = false;
+			binding.ActionDelegate.GetDelegateForManualSet().BindUObject(this, &AOmegaInputReplay::RecordAction, NumAxes + index * 2 + released);
+			RecorderInput->AddActionBinding(binding);
+		}
+	}
+
+	PlayerController->PushInputComponent(RecorderInput);
+
+	UE_LOG(LogOmegaInputReplay, Log, TEXT("recording %s at %.0f fps, seed %d"), *RecordingName, FixedFrameRate, Seed);
+}
+
+void AOmegaInputReplay::RecordAction(int32 Channel)
+{
+	AddChange(Channel, 0.f);
+}
+
+void AOmegaInputReplay::RecordAxis(float Value, int32 Axis)
+{
+	// axes are held until they change, most frames write nothing
+	if ((GFrameCounter < StartFrame) || (Value == LastAxisValues[Axis])) return;
+
+	LastAxisValues[Axis] = Value;
+	AddChange(Axis, Value);
+}
+
+void AOmegaInputReplay::AddChange(int32 Channel, float Value)
+{
+	if (bFinished || (GFrameCounter < StartFrame)) return;
+
+	const uint32 frame = (uint32)(GFrameCounter - StartFrame);
+	if (frame != PendingFrame) FlushFrame();
+
+	PendingFrame = frame;
+	PendingChanges.Add({ Channel, Value });
+}
+
+void AOmegaInputReplay::FlushFrame()
+{
+	if (PendingChanges.Num() == 0) return;
+
+	FMemoryWriter writer(Data, false, true);
+	uint32 frameDelta = PendingFrame - LastWrittenFrame;
+	uint32 count = PendingChanges.Num();
+	writer.SerializeIntPacked(frameDelta);
+	writer.SerializeIntPacked(count);
+
+	for (FInputChange& change : PendingChanges)
+	{
+		uint32 channel = change.Channel;
+		writer.SerializeIntPacked(channel);
+		if (change.Channel < NumAxes) writer << change.Value;
+	}
+
+	LastWrittenFrame = PendingFrame;
+	PendingChanges.Reset();
+}
+
+void AOmegaInputReplay::FinishRecording()
+{
+	bFinished = true;
+	if (!Character) return;
+
+	FlushFrame();
+
+	// the end marker sits on the last frame
+	const uint32 lastFrame = (GFrameCounter > StartFrame) ? (uint32)(GFrameCounter - StartFrame) : 0;
+	FMemoryWriter writer(Data, false, true);
+	uint32 frameDelta = FMath::Max(lastFrame, LastWrittenFrame) - LastWrittenFrame;
+	uint32 count = 0;
+	writer.SerializeIntPacked(frameDelta);
+	writer.SerializeIntPacked(count);
+
+	if (PlayerController)
+	{
+		PlayerController->RemoveTickPrerequisiteActor(this);
+		if (RecorderInput) PlayerController->PopInputComponent(RecorderInput);
+	}
+	if (!Character->IsPendingKill()) Character->RemoveTickPrerequisiteActor(this);
+	if (RecorderInput) RecorderInput->DestroyComponent();
+	RestoreTimestep();
+
+	const FString path = GetRecordingPath(RecordingName);
+	if (FFileHelper::SaveArrayToFile(Data, *path)) UE_LOG(LogOmegaInputReplay, Log, TEXT("%u frames (%d bytes) recorded to %s"), lastFrame, Data.Num(), *path);
+	else UE_LOG(LogOmegaInputReplay, Error, TEXT("couldn't write the recording to %s"), *path);
+}
+
+bool AOmegaInputReplay::ReadHeader()
+{
+	FMemoryReader reader(Data);
+	uint32 magic = 0;
+	uint16 version = 0;
+	reader << magic << version;
+	if (reader.IsError() || (magic != FileMagic) || (version != FileVersion)) return false;
+
+	FString mapName;
+	TArray<FString> axisNames;
+	TArray<FString> actionNames;
+	reader << Seed << FixedFrameRate << mapName << axisNames << actionNames;
+	if (reader.IsError()) return false;
+
+	if (mapName != GetWorld()->GetMapName())
+	{
+		UE_LOG(LogOmegaInputReplay, Warning, TEXT("%s was recorded on %s, this is %s"), *RecordingName, *mapName, *GetWorld()->GetMapName());
+	}
+
+	// match channels by name so recordings outlive changes to the bindings
+	const TArray<FOmegaAxisInput>& axes = AOmegaCharacter::GetAxisInputs();
+	const TArray<FOmegaActionInput>& actions = AOmegaCharacter::GetActionInputs();
+
+	NumAxes = axisNames.Num();
+	for (const FString& name : axisNames)
+	{
+		AxisMap.Add(axes.IndexOfByPredicate([&name](const FOmegaAxisInput& Input) { return Input.Name.ToString() == name; }));
+	}
+	for (const FString& name : actionNames)
+	{
+		ActionMap.Add(actions.IndexOfByPredicate([&name](const FOmegaActionInput& Input) { return Input.Name.ToString() == name; }));
+	}
+	AxisValues.Init(0.f, axes.Num());
+
+	ReadOffset = reader.Tell();
+	ReadNextFrame();
+	return true;
+}
+
+void AOmegaInputReplay::BeginReplay()
+{
+	// the recording stands in for the player
+	Character->DisableInput(PlayerController);
+
+	UE_LOG(LogOmegaInputReplay, Log, TEXT("replaying %s at %.0f fps, seed %d"), *RecordingName, FixedFrameRate, Seed);
+}
+
+void AOmegaInputReplay::ReadNextFrame()
+{
+	FMemoryReader reader(Data);
+	reader.Seek(ReadOffset);
+
+	uint32 frameDelta = 0;
+	uint32 count = 0;
+	reader.SerializeIntPacked(frameDelta);
+	reader.SerializeIntPacked(count);
+
+	NextChangeFrame += frameDelta;
+	NextChanges.Reset();
+
+	for (uint32 index = 0; (index < count) && !reader.IsError(); index++)
+	{
+		uint32 channel = 0;
+		float value = 0.f;
+		reader.SerializeIntPacked(channel);
+		if ((int32)channel < NumAxes) reader << value;
+		NextChanges.Add({ (int32)channel, value });
+	}
+
+	// a recording cut short ends where it was cut
+	bReachedEnd = (count == 0) || reader.IsError();
+	ReadOffset = reader.Tell();
+}
+
+void AOmegaInputReplay::ReplayFrame()
+{
+	const double now = FPlatformTime::Seconds();
+	if (LastFrameTime > 0.0)
+	{
+		FrameMs.Add((float)((now - LastFrameTime) * 1000.0));
+		GameThreadMs.Add((float)FPlatformTime::ToMilliseconds(GGameThreadTime));
+	}
+	LastFrameTime = now;
+
+	const TArray<FOmegaAxisInput>& axes = AOmegaCharacter::GetAxisInputs();
+	const TArray<FOmegaActionInput>& actions = AOmegaCharacter::GetActionInputs();
+
+	// actions fire in the order they were recorded, then every axis gets its held value, as the controller does
+	if (!bReachedEnd && (NextChangeFrame == Frame))
+	{
+		for (const FInputChange& change : NextChanges)
+		{
+			if (change.Channel < NumAxes)
+			{
+				const int32 axis = AxisMap[change.Channel];
+				if (axis != INDEX_NONE) AxisValues[axis] = change.Value;
+				continue;
+			}
+
+			const int32 recordedAction = (change.Channel - NumAxes) / 2;
+			const int32 action = ActionMap.IsValidIndex(recordedAction) ? ActionMap[recordedAction] : INDEX_NONE;
+			if (action == INDEX_NONE) continue;
+
+			void (AOmegaCharacter::*handler)() = ((change.Channel - NumAxes) % 2) ? actions[action].Released : actions[action].Pressed;
+			if (handler) (Character->*handler)();
+		}
+
+		ReadNextFrame();
+	}
+
+	for (int32 index = 0; index < axes.Num(); index++)
+	{
+		(Character->*axes[index].Handler)(AxisValues[index]);
+	}
+
+	Frame++;
+	if (!bReachedEnd || (Frame <= NextChangeFrame)) return;
+
+	FinishReplay();
+
+	if (bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+		return;
+	}
+
+	Destroy();
+}
+
+void AOmegaInputReplay::FinishReplay()
+{
+	bFinished = true;
+	if (!Character) return;
+
+	if (PlayerController) PlayerController->RemoveTickPrerequisiteActor(this);
+	if (!Character->IsPendingKill())
+	{
+		Character->RemoveTickPrerequisiteActor(this);
+		Character->EnableInput(PlayerController);
+	}
+	RestoreTimestep();
+
+	UE_LOG(LogOmegaInputReplay, Log, TEXT("replayed %u frames of %s"), Frame, *RecordingName);
+	WriteResults();
+}
+
+void AOmegaInputReplay::WriteResults() const
+{
+	FString output;
+	TSharedRef<TJsonWriter<>> writer = TJsonWriterFactory<>::Create(&output);
+
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("engine"), FEngineVersion::Current().ToString());
+	writer->WriteValue(TEXT("build_config"), FString(EBuildConfigurations::ToString(FApp::GetBuildConfiguration())));
+	writer->WriteValue(TEXT("map"), GetWorld()->GetMapName());
+	writer->WriteValue(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	writer->WriteValue(TEXT("recording"), RecordingName);
+	writer->WriteValue(TEXT("seed"), Seed);
+	writer->WriteValue(TEXT("fixed_frame_rate"), FixedFrameRate);
+	writer->WriteValue(TEXT("frames"), (int32)Frame);
+	writer->WriteValue(TEXT("completed"), bReachedEnd && (Frame > NextChangeFrame));
+	AOmegaBenchmark::WriteSummary(*writer, TEXT("frame_ms"), FrameMs);
+	AOmegaBenchmark::WriteSummary(*writer, TEXT("game_thread_ms"), GameThreadMs);
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	const FString path = FPaths::Combine(FPaths::GameSavedDir(), TEXT("Benchmarks"), FString::Printf(TEXT("OmegaReplay-%s-%s.json"), *RecordingName, *FDateTime::Now().ToString()));
+	if (FFileHelper::SaveStringToFile(output, *path)) UE_LOG(LogOmegaInputReplay, Log, TEXT("results written to %s"), *path);
+	else UE_LOG(LogOmegaInputReplay, Error, TEXT("couldn't write results to %s"), *path);
+}
+
+void AOmegaInputReplay::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// stopped early, a map change, or the end of PIE - keep what there is
+	if (!bFinished)
+	{
+		if (bReplaying) FinishReplay();
+		else FinishRecording();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
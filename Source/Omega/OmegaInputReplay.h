@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "OmegaInputReplay.generated.h"
+
+class AOmegaCharacter;
+class APlayerController;
+class UInputComponent;
+
+/**
+ * Records the local player's input to Saved/InputRecordings/<name>.omir and plays it back through the character's own
+ * input handlers. Both run on a fixed timestep with the same random seed, so a recording plays out the same on any
+ * build and the frame times of a replay can be compared between builds (written like the benchmark's, to Saved/Benchmarks).
+ *
+ * Record with OmegaRecordInput <name> / OmegaStopInput, or -OmegaRecord=<name>.
+ * Replay with OmegaReplayInput <name>, headless: -game -nullrhi -OmegaReplay=<name> -OmegaReplayQuit
+ */
+UCLASS(config=Game)
+class OMEGA_API AOmegaInputReplay : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AOmegaInputReplay();
+
+	/** both start once the local player has a character, any recording or replay already running is stopped first */
+	static AOmegaInputReplay* StartRecording(UWorld* World, const FString& RecordingName);
+	static AOmegaInputReplay* StartReplay(UWorld* World, const FString& RecordingName, bool bQuitWhenDone);
+	/** saves the recording, or ends the replay early */
+	static void Stop(UWorld* World);
+
+protected:
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** the frame rate recording and replay are locked to */
+	UPROPERTY(Config)
+	float FixedFrameRate = 60.f;
+
+private:
+	static constexpr uint32 FileMagic = 0x52494D4F; // "OMIR"
+	static constexpr uint16 FileVersion = 1;
+
+	static FString GetRecordingPath(const FString& RecordingName);
+
+	bool TryBegin();
+	void BeginRecording();
+	bool ReadHeader();
+	void BeginReplay();
+	void LockTimestep();
+	void RestoreTimestep();
+
+	// recording: the recorder's bindings sit above the character's and let the input through
+	void RecordAction(int32 Channel);
+	void RecordAxis(float Value, int32 Axis);
+	void AddChange(int32 Channel, float Value);
+	void FlushFrame();
+	void FinishRecording();
+
+	// replay
+	void ReplayFrame();
+	void ReadNextFrame();
+	void FinishReplay();
+	void WriteResults() const;
+
+	bool bReplaying = false;
+	bool bQuitWhenDone = false;
+	bool bFinished = false;
+	FString RecordingName;
+
+	UPROPERTY()
+	AOmegaCharacter* Character;
+	UPROPERTY()
+	APlayerController* PlayerController;
+	UPROPERTY()
+	UInputComponent* RecorderInput;
+
+	int32 Seed = 0;
+	bool bTimestepLocked = false;
+	bool bPreviousUseFixedTimeStep = false;
+	double PreviousFixedDeltaTime = 0.0;
+
+	/**
+	 * The file is the header (magic, version, seed, frame rate, map, the axis and action names the channels index)
+	 * followed by the frames that changed anything: packed frames since the last one, packed change count, then each
+	 * change as a packed channel plus the new value for axes. Axes are held between changes. A frame with no changes
+	 * ends the file, the frame it's on is the length of the recording.
+	 * Channels are the axes first, then each action's pressed and released.
+	 */
+	struct FInputChange
+	{
+		int32 Channel;
+		float Value;
+	};
+
+	TArray<uint8> Data;
+	int32 NumAxes = 0;
+
+	// recording
+	uint64 StartFrame = 0;
+	uint32 PendingFrame = 0;
+	uint32 LastWrittenFrame = 0;
+	TArray<FInputChange> PendingChanges;
+	TArray<float> LastAxisValues;
+
+	// replay, recorded channels mapped onto this build's inputs (INDEX_NONE where an input no longer exists)
+	int64 ReadOffset = 0;
+	uint32 Frame = 0;
+	uint32 NextChangeFrame = 0;
+	bool bReachedEnd = false;
+	TArray<int32> AxisMap;
+	TArray<int32> ActionMap;
+	TArray<float> AxisValues;
+	TArray<FInputChange> NextChanges;
+
+	double LastFrameTime = 0.0;
+	TArray<float> FrameMs;
+	TArray<float> GameThreadMs;
+};
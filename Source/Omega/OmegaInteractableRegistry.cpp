@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaInteractableRegistry.h"
+#include "Engine/World.h"
+#include "Components/SceneComponent.h"
+
+const float FOmegaInteractableRegistry::CellSize = 500.f;
+
+namespace
+{
+	// weak keys, a world allocated where a destroyed one was doesn't pick up its registry
+	TMap<TWeakObjectPtr<UWorld>, TUniquePtr<FOmegaInteractableRegistry>> WorldRegistries;
+}
+
+FOmegaInteractableRegistry& FOmegaInteractableRegistry::Get(UWorld* World)
+{
+	static bool bCleanupBound = false;
+	if (!bCleanupBound)
+	{
+		// registries go away with their world, actors have already unregistered themselves in EndPlay by then
+		FWorldDelegates::OnWorldCleanup.AddLambda([](UWorld* CleanedWorld, bool bSessionEnded, bool bCleanupResources)
+		{
+			WorldRegistries.Remove(CleanedWorld);
+		});
+		bCleanupBound = true;
+	}
+
+	if (TUniquePtr<FOmegaInteractableRegistry>* Existing = WorldRegistries.Find(World)) return **Existing;
+
+	// a world that went away without a cleanup (a failed load, say) leaves a stale entry behind, drop those here
+	for (auto It = WorldRegistries.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid()) It.RemoveCurrent();
+	}
+
+	TUniquePtr<FOmegaInteractableRegistry>& Registry = WorldRegistries.Add(World, MakeUnique<FOmegaInteractableRegistry>());
+	return *Registry;
+}
+
+FOmegaInteractableRegistry::~FOmegaInteractableRegistry()
+{
+	for (const FEntry& Entry : Entries)
+	{
+		if (USceneComponent* Root = Entry.Root.Get()) Root->TransformUpdated.Remove(Entry.MovedHandle);
+	}
+}
+
+FBoxSphereBounds FOmegaInteractableRegistry::GetActorBounds(const AActor* Actor)
+{
+	FVector Origin;
+	FVector Extent;
+	Actor->GetActorBounds(false, Origin, Extent);
+	return FBoxSphereBounds(Origin, Extent, Extent.Size());
+}
+
+void FOmegaInteractableRegistry::Register(AActor* Actor, EViewTargetState ReticleTag)
+{
+	if (!Actor || EntryIndices.Contains(Actor)) return;
+
+	FEntry Entry;
+	Entry.Actor = Actor;
+	Entry.Bounds = GetActorBounds(Actor);
+	Entry.ReticleTag = ReticleTag;
+	Entry.Root = Actor->GetRootComponent();
+
+	const int32 Index = Entries.Add(Entry);
+	EntryIndices.Add(Actor, Index);
+	AddToCells(Index);
+
+	if (USceneComponent* Root = Actor->GetRootComponent())
+	{
+		Entries[Index].MovedHandle = Root->TransformUpdated.AddRaw(this, &FOmegaInteractableRegistry::OnActorMoved, Index);
+	}
+}
+
+void FOmegaInteractableRegistry::Unregister(AActor* Actor)
+{
+	int32 Index = INDEX_NONE;
+	if (!EntryIndices.RemoveAndCopyValue(Actor, Index)) return;
+
+	if (USceneComponent* Root = Entries[Index].Root.Get()) Root->TransformUpdated.Remove(Entries[Index].MovedHandle);
+
+	RemoveFromCells(Index);
+	Entries.RemoveAt(Index);
+}
+
+void FOmegaInteractableRegistry::AddToCells(int32 Index)
+{
+	// large cover pieces span several cells, store them in each one
+	ForEachCell(Entries[Index].Bounds.GetBox(), [this, Index](const FIntVector& Cell)
+	{
+		Cells.FindOrAdd(Cell).Add(Index);
+	});
+}
+
+void FOmegaInteractableRegistry::RemoveFromCells(int32 Index)
+{
+	ForEachCell(Entries[Index].Bounds.GetBox(), [this, Index](const FIntVector& Cell)
+	{
+		TArray<int32>* CellEntries = Cells.Find(Cell);
+		if (!CellEntries) return;
+
+		CellEntries->RemoveSingleSwap(Index);
+		if (CellEntries->Num() == 0) Cells.Remove(Cell);
+	});
+}
+
+void FOmegaInteractableRegistry::OnActorMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, int32 Index)
+{
+	FEntry& Entry = Entries[Index];
+	const AActor* Actor = Entry.Actor.Get();
+	if (!Actor) return;
+
+	const FBoxSphereBounds NewBounds = GetActorBounds(Actor);
+	const FBox OldBox = Entry.Bounds.GetBox();
+	const FBox NewBox = NewBounds.GetBox();
+
+	// most moves stay within the same cells, only the bounds need updating then
+	if ((GetCell(OldBox.Min) == GetCell(NewBox.Min)) && (GetCell(OldBox.Max) == GetCell(NewBox.Max)))
+	{
+		Entry.Bounds = NewBounds;
+		return;
+	}
+
+	RemoveFromCells(Index);
+	Entry.Bounds = NewBounds;
+	AddToCells(Index);
+}
+
+EViewTargetState FOmegaInteractableRegistry::GetReticleTag(const AActor* Actor) const
+{
+	const int32* Index = EntryIndices.Find(Actor);
+	return (Index) ? Entries[*Index].ReticleTag : EViewTargetState::VTS_DEFAULT;
+}
+
+void FOmegaInteractableRegistry::QueryCone(const FVector& Origin, const FVector& Direction, float Range, float HalfAngleDegrees, TArray<AActor*, TInlineAllocator<8>>& OutCandidates) const
+{
+	const float TanHalfAngle = FMath::Tan(FMath::DegreesToRadians(HalfAngleDegrees));
+	const FVector End = Origin + Direction * Range;
+
+	FBox QueryBox(ForceInit);
+	QueryBox += Origin;
+	QueryBox += End;
+	QueryBox = QueryBox.ExpandBy(Range * TanHalfAngle);
+
+	TArray<int32, TInlineAllocator<16>> Visited;
+
+	ForEachCell(QueryBox, [&](const FIntVector& Cell)
+	{
+		const TArray<int32>* CellEntries = Cells.Find(Cell);
+		if (!CellEntries) return;
+
+		for (int32 Index : *CellEntries)
+		{
+			if (Visited.Contains(Index)) continue;
+			Visited.Add(Index);
+
+			const FEntry& Entry = Entries[Index];
+			AActor* Actor = Entry.Actor.Get();
+			if (!Actor) continue;
+
+			// bounding sphere against the cone: along-axis distance first, then distance off the axis
+			const FVector ToCenter = Entry.Bounds.Origin - Origin;
+			const float AlongAxis = FVector::DotProduct(ToCenter, Direction);
+			if ((AlongAxis < -Entry.Bounds.SphereRadius) || (AlongAxis > Range + Entry.Bounds.SphereRadius)) continue;
+
+			const float OffAxis = (ToCenter - Direction * AlongAxis).Size();
+			if (OffAxis > FMath::Max(AlongAxis, 0.f) * TanHalfAngle + Entry.Bounds.SphereRadius) continue;
+
+			OutCandidates.Add(Actor);
+		}
+	});
+}
+
+FIntVector FOmegaInteractableRegistry::GetCell(const FVector& Location) const
+{
+	return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void FOmegaInteractableRegistry::ForEachCell(const FBox& Box, TFunctionRef<void(const FIntVector&)> Func) const
+{
+	const FIntVector MinCell = GetCell(Box.Min);
+	const FIntVector MaxCell = GetCell(Box.Max);
+
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				Func(FIntVector(X, Y, Z));
+			}
+		}
+	}
+}
@@ -0,0 +1,56 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "OmegaCharacter.h"
+
+/**
+ * World-level registry of interactable actors (pickups and cover). Each entry carries the reticle state it
+ * resolves to and is bucketed into a uniform grid, so lookups and range queries don't depend on casting
+ * traced actors or on how many interactables the map holds. Entries follow their actor's root component,
+ * an actor that moves is re-bucketed as it goes.
+ */
+class OMEGA_API FOmegaInteractableRegistry
+{
+public:
+	/** returns the registry for the given world, creating it on first use */
+	static FOmegaInteractableRegistry& Get(UWorld* World);
+
+	~FOmegaInteractableRegistry();
+
+	void Register(AActor* Actor, EViewTargetState ReticleTag);
+	void Unregister(AActor* Actor);
+
+	/** the reticle state the actor was registered with, VTS_DEFAULT if it isn't an interactable */
+	EViewTargetState GetReticleTag(const AActor* Actor) const;
+
+	/** gathers registered actors within Range of Origin whose bounds touch the cone around Direction */
+	void QueryCone(const FVector& Origin, const FVector& Direction, float Range, float HalfAngleDegrees, TArray<AActor*, TInlineAllocator<8>>& OutCandidates) const;
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<AActor> Actor;
+		FBoxSphereBounds Bounds;
+		EViewTargetState ReticleTag;
+		// the root component's TransformUpdated binding
+		TWeakObjectPtr<USceneComponent> Root;
+		FDelegateHandle MovedHandle;
+	};
+
+	static FBoxSphereBounds GetActorBounds(const AActor* Actor);
+	void AddToCells(int32 Index);
+	void RemoveFromCells(int32 Index);
+	void OnActorMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport, int32 Index);
+
+	FIntVector GetCell(const FVector& Location) const;
+	void ForEachCell(const FBox& Box, TFunctionRef<void(const FIntVector&)> Func) const;
+
+	TSparseArray<FEntry> Entries;
+	TMap<const AActor*, int32> EntryIndices;
+	TMap<FIntVector, TArray<int32>> Cells;
+
+	static const float CellSize;
+};
@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaLagCompensation.h"
+#include "Omega.h"
+#include "OmegaCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+void FOmegaPoseHistory::Init(int32 Capacity)
+{
+	Samples.SetNum(FMath::Max(Capacity, 2));
+	Head = 0;
+	Count = 0;
+}
+
+void FOmegaPoseHistory::Record(float Time, const FVector& Location, float HalfHeight, float Radius)
+{
+	if (Samples.Num() == 0) return;
+
+	FOmegaPoseSample& Sample = Samples[Head];
+	Sample.Time = Time;
+	Sample.Location = Location;
+	Sample.HalfHeight = HalfHeight;
+	Sample.Radius = Radius;
+
+	Head = (Head + 1) % Samples.Num();
+	Count = FMath::Min(Count + 1, Samples.Num());
+}
+
+const FOmegaPoseSample& FOmegaPoseHistory::GetSample(int32 Age) const
+{
+	// age 0 is the newest sample
+	return Samples[(Head - 1 - Age + Samples.Num()) % Samples.Num()];
+}
+
+bool FOmegaPoseHistory::Sample(float Time, FOmegaPoseSample& OutSample) const
+{
+	if (Count == 0) return false;
+
+	for (int32 Age = 0; Age < Count; Age++)
+	{
+		const FOmegaPoseSample& Older = GetSample(Age);
+		if (Older.Time > Time) continue;
+
+		if (Age == 0)
+		{
+			OutSample = Older;
+			return true;
+		}
+
+		const FOmegaPoseSample& Newer = GetSample(Age - 1);
+		const float Alpha = (Newer.Time > Older.Time) ? (Time - Older.Time) / (Newer.Time - Older.Time) : 0.f;
+
+		OutSample.Time = Time;
+		OutSample.Location = FMath::Lerp(Older.Location, Newer.Location, Alpha);
+		OutSample.HalfHeight = FMath::Lerp(Older.HalfHeight, Newer.HalfHeight, Alpha);
+		OutSample.Radius = FMath::Lerp(Older.Radius, Newer.Radius, Alpha);
+		return true;
+	}
+
+	// older than anything recorded, use the oldest sample
+	OutSample = GetSample(Count - 1);
+	return true;
+}
+
+namespace
+{
+	// distance along the ray to where it enters the capsule, if it does
+	bool IntersectCapsule(const FVector& Start, const FVector& Direction, float Length, const FOmegaPoseSample& Capsule, float& OutDistance)
+	{
+		const float AxisHalfLength = FMath::Max(Capsule.HalfHeight - Capsule.Radius, 0.f);
+		const FVector AxisTop = Capsule.Location + FVector(0.f, 0.f, AxisHalfLength);
+		const FVector AxisBottom = Capsule.Location - FVector(0.f, 0.f, AxisHalfLength);
+
+		FVector OnRay;
+		FVector OnAxis;
+		FMath::SegmentDistToSegmentSafe(Start, Start + Direction * Length, AxisBottom, AxisTop, OnRay, OnAxis);
+
+		const float RadiusSquared = FMath::Square(Capsule.Radius);
+		if ((OnRay - OnAxis).SizeSquared() > RadiusSquared) return false;
+
+		// back off from the closest approach to the surface of the sphere around the closest axis point
+		const float Along = FVector::DotProduct(OnAxis - Start, Direction);
+		const float OffRaySquared = (Start + Direction * Along - OnAxis).SizeSquared();
+		OutDistance = FMath::Clamp(Along - FMath::Sqrt(FMath::Max(RadiusSquared - OffRaySquared, 0.f)), 0.f, Length);
+
+		return true;
+	}
+}
+
+bool OmegaLagCompensation::LineTraceRewound(UWorld* World, const FVector& Start, const FVector& End, float RewindTime, AOmegaCharacter* Shooter, const FCollisionQueryParams& Params, FHitResult& OutHit)
+{
+	const FVector Direction = (End - Start).GetSafeNormal();
+	const float Length = (End - Start).Size();
+	const float TargetTime = World->GetTimeSeconds() - RewindTime;
+
+	struct FRewoundCandidate
+	{
+		AOmegaCharacter* Character;
+		FOmegaPoseSample Capsule;
+	};
+	TArray<FRewoundCandidate, TInlineAllocator<16>> Rewound;
+
+	// characters with history near the ray are resolved against it below and skipped by the scene trace,
+	// every other pawn still blocks the shot where it stands now
+	FCollisionQueryParams SceneParams = Params;
+
+	for (TActorIterator<AOmegaCharacter> It(World); It; ++It)
+	{
+		AOmegaCharacter* Candidate = *It;
+		if (Candidate == Shooter) continue;
+
+		// only characters that could have been on the ray within the rewind window are sampled
+		const float CandidateReach = Candidate->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + Candidate->GetCharacterMovement()->GetMaxSpeed() * RewindTime;
+		if (FMath::PointDistToSegmentSquared(Candidate->GetActorLocation(), Start, End) > FMath::Square(CandidateReach)) continue;
+
+		FOmegaPoseSample Capsule;
+		if (!Candidate->GetPoseHistory().Sample(TargetTime, Capsule)) continue;
+
+		Rewound.Add({ Candidate, Capsule });
+		SceneParams.AddIgnoredActor(Candidate);
+	}
+
+	INC_DWORD_STAT(STAT_OmegaTracesIssued);
+	bool bHit = World->LineTraceSingleByObjectType(OutHit, Start, End, OmegaObjectQueries::Combat, SceneParams);
+	float ClosestDistance = (bHit) ? OutHit.Distance : Length;
+
+	for (const FRewoundCandidate& Candidate : Rewound)
+	{
+		float HitDistance = 0.f;
+		if (!IntersectCapsule(Start, Direction, Length, Candidate.Capsule, HitDistance) || (HitDistance >= ClosestDistance)) continue;
+
+		ClosestDistance = HitDistance;
+		bHit = true;
+
+		OutHit = FHitResult(Candidate.Character, Candidate.Character->GetCapsuleComponent(), Start + Direction * HitDistance, -Direction);
+		OutHit.TraceStart = Start;
+		OutHit.TraceEnd = End;
+		OutHit.Distance = HitDistance;
+		OutHit.Time = (Length > 0.f) ? HitDistance / Length : 0.f;
+	}
+
+	return bHit;
+}
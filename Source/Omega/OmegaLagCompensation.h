@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+
+class AOmegaCharacter;
+
+/** a character's collision capsule at one point in server time */
+struct FOmegaPoseSample
+{
+	float Time = 0.f;
+	FVector Location = FVector::ZeroVector;
+	float HalfHeight = 0.f;
+	float Radius = 0.f;
+};
+
+/** fixed-size ring buffer of capsule samples, recorded once per server tick - memory is bounded by the capacity */
+class OMEGA_API FOmegaPoseHistory
+{
+public:
+	void Init(int32 Capacity);
+	void Record(float Time, const FVector& Location, float HalfHeight, float Radius);
+
+	/** the capsule at the given time, interpolated between the samples around it and clamped to the recorded range */
+	bool Sample(float Time, FOmegaPoseSample& OutSample) const;
+
+private:
+	const FOmegaPoseSample& GetSample(int32 Age) const;
+
+	TArray<FOmegaPoseSample> Samples;
+	int32 Head = 0;
+	int32 Count = 0;
+};
+
+namespace OmegaLagCompensation
+{
+	/**
+	 * Traces a hitscan shot with every other character rewound by RewindTime. Characters near the ray are tested
+	 * analytically against their recorded capsules and the world is traced with only those left out, so nothing has
+	 * to be moved in the physics scene and restored afterwards, and other pawns still block where they stand.
+	 */
+	OMEGA_API bool LineTraceRewound(UWorld* World, const FVector& Start, const FVector& End, float RewindTime, AOmegaCharacter* Shooter, const FCollisionQueryParams& Params, FHitResult& OutHit);
+}
@@ -2,6 +2,11 @@
 
 #include "OmegaObjectivePickup.h"
 
+AOmegaObjectivePickup::AOmegaObjectivePickup()
+{
+	ReticleTag = EViewTargetState::VTS_OBJECT;
+}
+
 void AOmegaObjectivePickup::Pickup(AOmegaCharacter * ActingPlayer)
 {
 	// complete objective
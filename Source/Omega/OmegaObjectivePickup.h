@@ -19,6 +19,8 @@ protected:
 	int32 AmmoValue = 50.f;
 
 public:
+	AOmegaObjectivePickup();
+
 	UFUNCTION(BlueprintCallable, Category = "Pickup")
 	virtual void Pickup(class AOmegaCharacter* ActingPlayer) override;	
 	
@@ -1,9 +1,14 @@
 // Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
 
 #include "OmegaProjectile.h"
+#include "Omega.h"
 #include "GameFramework/ProjectileMovementComponent.h"
 #include "Components/SphereComponent.h"
 #include "OmegaCharacter.h"
+#include "OmegaProjectilePool.h"
+#include "OmegaDamageQueue.h"
+#include "OmegaTelemetry.h"
+#include "Engine/World.h"
 
 AOmegaProjectile::AOmegaProjectile() 
 {
@@ -34,21 +39,97 @@ AOmegaProjectile::AOmegaProjectile()
 
 void AOmegaProjectile::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
-	// Only add impulse and destroy projectile if we hit a physics
-	if ((OtherActor != NULL) && (OtherActor != this) && (OtherComp != NULL))
+	// Only add impulse and destroy projectile if we hit a physics - projectiles a client fired ahead of the server are cosmetic
+	if ((OtherActor != NULL) && (OtherActor != this) && (OtherComp != NULL) && OmegaNet::IsGameplayAuthority(GetWorld()))
 	{
+		AOmegaDamageQueue* Queue = AOmegaDamageQueue::Get(GetWorld());
+		FOmegaTelemetry::RecordHit(Instigator, this, OtherActor, Hit.Location);
+
 		if (OtherComp->IsSimulatingPhysics())
 		{
-			OtherComp->AddImpulseAtLocation(GetVelocity() * ProjectileForce, GetActorLocation());
-			Destroy();
+			Queue->AddImpulse(OtherComp, GetVelocity() * ProjectileForce, GetActorLocation());
+			Expire();
 		}
 		
 		AOmegaCharacter* omegaActor = Cast<AOmegaCharacter>(OtherActor);
 
 		if (omegaActor)
 		{
-			omegaActor->ReceiveDamage(ProjectileDamage);
-			Destroy();
+			Queue->AddDamage(omegaActor, ProjectileDamage);
+			Expire();
 		}
 	}
-}
\ No newline at end of file
+}
+
+void AOmegaProjectile::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// the pool parks its projectiles straight after spawning them
+	SetCountedAlive(true);
+}
+
+void AOmegaProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	SetCountedAlive(false);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AOmegaProjectile::SetCountedAlive(bool bAlive)
+{
+	if (bAlive == bIsCountedAlive) return;
+
+	bIsCountedAlive = bAlive;
+	if (bAlive) INC_DWORD_STAT(STAT_OmegaProjectilesAlive);
+	else DEC_DWORD_STAT(STAT_OmegaProjectilesAlive);
+}
+
+bool AOmegaProjectile::ActivateFromPool(AOmegaProjectilePool* Pool, const FVector& Location, const FRotator& Rotation)
+{
+	SetActorEnableCollision(true);
+
+	if (GetWorld()->EncroachingBlockingGeometry(this, Location, Rotation))
+	{
+		SetActorEnableCollision(false);
+		return false;
+	}
+
+	OwningPool = Pool;
+	bIsPoolActive = true;
+	PoolExpireTime = GetWorld()->GetTimeSeconds() + InitialLifeSpan;
+
+	SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::TeleportPhysics);
+	SetActorHiddenInGame(false);
+
+	// movement stops simulating on impact, so hook the collision back up and relaunch along the new rotation
+	ProjectileMovement->SetUpdatedComponent(CollisionComp);
+	ProjectileMovement->Velocity = Rotation.Vector() * ProjectileMovement->InitialSpeed;
+	ProjectileMovement->UpdateComponentVelocity();
+	ProjectileMovement->SetComponentTickEnabled(true);
+
+	SetCountedAlive(true);
+	return true;
+}
+
+void AOmegaProjectile::DeactivateForPool()
+{
+	bIsPoolActive = false;
+	SetCountedAlive(false);
+
+	ProjectileMovement->StopMovementImmediately();
+	ProjectileMovement->SetComponentTickEnabled(false);
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	// pooled projectiles expire through the pool, not their life span
+	SetLifeSpan(0.f);
+}
+
+void AOmegaProjectile::Expire()
+{
+	AOmegaProjectilePool* Pool = OwningPool.Get();
+
+	if (Pool) Pool->Release(this);
+	else Destroy();
+}
@@ -22,6 +22,17 @@ class AOmegaProjectile : public AActor
 public:
 	AOmegaProjectile();
 
+	/** places a pooled projectile and sets it moving, fails if it would start inside blocking geometry */
+	bool ActivateFromPool(class AOmegaProjectilePool* Pool, const FVector& Location, const FRotator& Rotation);
+	/** stops, hides and disables collision on a pooled projectile */
+	void DeactivateForPool();
+
+	FORCEINLINE bool IsPoolActive() const { return bIsPoolActive; }
+	FORCEINLINE float GetPoolExpireTime() const { return PoolExpireTime; }
+
+	FORCEINLINE float GetProjectileDamage() const { return ProjectileDamage; }
+	FORCEINLINE float GetProjectileForce() const { return ProjectileForce; }
+
 	/** Returns CollisionComp subobject **/
 	FORCEINLINE class USphereComponent* GetCollisionComp() const { return CollisionComp; }
 	/** Returns ProjectileMovement subobject **/
@@ -37,5 +48,20 @@ protected:
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Damage", meta = (ClampMin = 0.2f, ClampMax = 2000.f))
 	float ProjectileForce = 100.f;
+
+	/** returns pooled projectiles to their pool, destroys the rest */
+	void Expire();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	TWeakObjectPtr<class AOmegaProjectilePool> OwningPool;
+	bool bIsPoolActive = false;
+	float PoolExpireTime = 0.f;
+
+	// whether this projectile is in the Projectiles Alive stat - in flight, not parked in a pool
+	void SetCountedAlive(bool bAlive);
+	bool bIsCountedAlive = false;
 };
 
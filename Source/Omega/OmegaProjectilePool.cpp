@@ -0,0 +1,159 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaProjectilePool.h"
+#include "OmegaProjectile.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogProjectilePool, Log, All);
+
+AOmegaProjectilePool::AOmegaProjectilePool()
+{
+	// ticks to expire active projectiles, in place of a life span timer per projectile
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+AOmegaProjectilePool* AOmegaProjectilePool::Get(UWorld* World)
+{
+	if (!World) return nullptr;
+
+	for (TActorIterator<AOmegaProjectilePool> It(World); It; ++It)
+	{
+		return *It;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AOmegaProjectilePool>(SpawnParams);
+}
+
+void AOmegaProjectilePool::Prewarm(TSubclassOf<AOmegaProjectile> ProjectileClass)
+{
+	if (!ProjectileClass) return;
+
+	FOmegaProjectileClassPool& Pool = Pools.FindOrAdd(ProjectileClass);
+	const int32 TargetCount = FMath::Min(PrewarmCount, MaxPerClass);
+
+	while (Pool.Free.Num() + Pool.Active.Num() < TargetCount)
+	{
+		AOmegaProjectile* Projectile = SpawnPooledProjectile(ProjectileClass);
+		if (!Projectile) break;
+
+		Pool.Free.Add(Projectile);
+	}
+}
+
+AOmegaProjectile* AOmegaProjectilePool::Acquire(TSubclassOf<AOmegaProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, EProjectilePoolResult& OutResult)
+{
+	OutResult = EProjectilePoolResult::Exhausted;
+	if (!ProjectileClass) return nullptr;
+
+	FOmegaProjectileClassPool& Pool = Pools.FindOrAdd(ProjectileClass);
+	Pool.Requests++;
+
+	AOmegaProjectile* Projectile = nullptr;
+
+	if (Pool.Free.Num() > 0)
+	{
+		Projectile = Pool.Free.Pop(false);
+		Pool.Hits++;
+	}
+	else if ((Pool.Active.Num() < MaxPerClass) || (OverflowPolicy == EProjectilePoolOverflow::PPO_SpawnExtra))
+	{
+		// a failed spawn is counted under Failed below
+		Projectile = SpawnPooledProjectile(ProjectileClass);
+		if (Projectile) Pool.Spawned++;
+	}
+	else if ((OverflowPolicy == EProjectilePoolOverflow::PPO_RecycleOldest) && (Pool.Active.Num() > 0))
+	{
+		Projectile = Pool.Active[0];
+		Pool.Active.RemoveAt(0, 1, false);
+		Projectile->DeactivateForPool();
+		Pool.Recycled++;
+	}
+
+	if (!Projectile)
+	{
+		Pool.Failed++;
+		return nullptr;
+	}
+
+	// same rule as spawning with AdjustIfPossibleButDontSpawnIfColliding, minus the adjustment
+	if (!Projectile->ActivateFromPool(this, Location, Rotation))
+	{
+		Pool.Free.Add(Projectile);
+		Pool.Failed++;
+		OutResult = EProjectilePoolResult::Blocked;
+		return nullptr;
+	}
+
+	Pool.Active.Add(Projectile);
+	Pool.PeakActive = FMath::Max(Pool.PeakActive, Pool.Active.Num());
+
+	OutResult = EProjectilePoolResult::Acquired;
+	return Projectile;
+}
+
+void AOmegaProjectilePool::Release(AOmegaProjectile* Projectile)
+{
+	if (!Projectile || !Projectile->IsPoolActive()) return;
+
+	Projectile->DeactivateForPool();
+
+	FOmegaProjectileClassPool* Pool = Pools.Find(Projectile->GetClass());
+	if (!Pool) return;
+
+	Pool->Active.RemoveSingle(Projectile);
+
+	// extras spawned past the cap aren't kept around
+	if (Pool->Free.Num() + Pool->Active.Num() >= MaxPerClass) Projectile->Destroy();
+	else Pool->Free.Add(Projectile);
+}
+
+void AOmegaProjectilePool::LogStats() const
+{
+	for (const TPair<UClass*, FOmegaProjectileClassPool>& Entry : Pools)
+	{
+		const FOmegaProjectileClassPool& Pool = Entry.Value;
+		const float HitRate = (Pool.Requests > 0) ? (100.f * Pool.Hits) / Pool.Requests : 0.f;
+
+		UE_LOG(LogProjectilePool, Log, TEXT("%s: %d requests, %.1f%% hit rate, peak %d active, %d spawned, %d recycled, %d failed"),
+			*GetNameSafe(Entry.Key), Pool.Requests, HitRate, Pool.PeakActive, Pool.Spawned, Pool.Recycled, Pool.Failed);
+	}
+}
+
+void AOmegaProjectilePool::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	for (TPair<UClass*, FOmegaProjectileClassPool>& Entry : Pools)
+	{
+		// activation order means expiry order, stop at the first one still alive
+		TArray<AOmegaProjectile*>& Active = Entry.Value.Active;
+		while ((Active.Num() > 0) && (!Active[0] || (Active[0]->GetPoolExpireTime() <= Now)))
+		{
+			if (Active[0]) Release(Active[0]);
+			else Active.RemoveAt(0, 1, false);
+		}
+	}
+}
+
+void AOmegaProjectilePool::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	LogStats();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+AOmegaProjectile* AOmegaProjectilePool::SpawnPooledProjectile(TSubclassOf<AOmegaProjectile> ProjectileClass)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AOmegaProjectile* Projectile = GetWorld()->SpawnActor<AOmegaProjectile>(ProjectileClass, GetActorLocation(), FRotator::ZeroRotator, SpawnParams);
+	if (Projectile) Projectile->DeactivateForPool();
+
+	return Projectile;
+}
@@ -0,0 +1,95 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Info.h"
+#include "OmegaProjectilePool.generated.h"
+
+class AOmegaProjectile;
+
+UENUM(BlueprintType)
+enum class EProjectilePoolOverflow : uint8
+{
+	PPO_SpawnExtra		UMETA(DisplayName = "Spawn Extra"),
+	PPO_RecycleOldest	UMETA(DisplayName = "Recycle Oldest"),
+	PPO_Fail			UMETA(DisplayName = "Fail")
+};
+
+/** why Acquire did or didn't hand out a projectile */
+enum class EProjectilePoolResult : uint8
+{
+	Acquired,
+	// nothing free, at MaxPerClass with nothing to recycle, or the pooled spawn failed - the shot is dropped
+	Exhausted,
+	// refused by blocking geometry at the spawn point, like a spawn with AdjustIfPossibleButDontSpawnIfColliding
+	Blocked
+};
+
+/** pooled projectiles of one class, plus the usage numbers used to size the pool */
+USTRUCT()
+struct FOmegaProjectileClassPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AOmegaProjectile*> Free;
+	/** in activation order, oldest first */
+	UPROPERTY()
+	TArray<AOmegaProjectile*> Active;
+
+	int32 Requests = 0;
+	int32 Hits = 0;
+	int32 Spawned = 0;
+	int32 Recycled = 0;
+	int32 Failed = 0;
+	int32 PeakActive = 0;
+};
+
+/**
+ * World-level pool of projectile actors, one free list per projectile class. Projectiles are activated, reset
+ * and deactivated instead of being spawned and destroyed per shot, and expire here rather than through their life span.
+ */
+UCLASS(config=Game)
+class OMEGA_API AOmegaProjectilePool : public AInfo
+{
+	GENERATED_BODY()
+
+public:
+	AOmegaProjectilePool();
+
+	/** returns the world's projectile pool, spawning it on first use */
+	static AOmegaProjectilePool* Get(UWorld* World);
+
+	/** spawns inactive projectiles of the class until PrewarmCount are available */
+	void Prewarm(TSubclassOf<AOmegaProjectile> ProjectileClass);
+
+	/** activates a projectile at the given transform, returns null if none could be placed there or the pool is exhausted - OutResult says which */
+	AOmegaProjectile* Acquire(TSubclassOf<AOmegaProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, EProjectilePoolResult& OutResult);
+
+	/** deactivates a projectile and returns it to its free list */
+	void Release(AOmegaProjectile* Projectile);
+
+	/** writes hit rate and peak usage per projectile class to the log */
+	UFUNCTION(BlueprintCallable, Category = "Projectile Pool")
+	void LogStats() const;
+
+	/** inactive projectiles spawned per class the first time it's used */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Projectile Pool", meta = (ClampMin = 0))
+	int32 PrewarmCount = 16;
+	/** most projectiles of one class the pool keeps alive, see OverflowPolicy for what happens past it */
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Projectile Pool", meta = (ClampMin = 1))
+	int32 MaxPerClass = 64;
+	UPROPERTY(Config, EditDefaultsOnly, Category = "Projectile Pool")
+	EProjectilePoolOverflow OverflowPolicy = EProjectilePoolOverflow::PPO_RecycleOldest;
+
+protected:
+	virtual void Tick(float DeltaSeconds) override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	AOmegaProjectile* SpawnPooledProjectile(TSubclassOf<AOmegaProjectile> ProjectileClass);
+
+	UPROPERTY()
+	TMap<UClass*, FOmegaProjectileClassPool> Pools;
+};
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OmegaCharacter.h"
+#include "CoverActorBase.h"
+#include "Pickup.h"
+#include "Camera/CameraComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+
+/** sweeps camera rays from the player and from in front of each interactable, comparing both reticle resolvers */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FOmegaReticleSweepCommand, FAutomationTestBase*, Test);
+
+namespace
+{
+	// aim locations come from traces of different lengths along the same ray
+	const float AimTolerance = 0.1f;
+	// errors reported before the rest are just counted
+	const int32 MaxReportedMismatches = 10;
+}
+
+bool FOmegaReticleSweepCommand::Update()
+{
+	AOmegaCharacter* character = OmegaTests::GetPlayerCharacter();
+	APlayerController* controller = (character) ? Cast<APlayerController>(character->GetController()) : nullptr;
+	if (!controller) return true;
+
+	const FVector savedLocation = character->GetActorLocation();
+	const FRotator savedRotation = controller->GetControlRotation();
+	const bool bSavedAsync = character->bAsyncReticleTrace;
+	character->bAsyncReticleTrace = false;
+
+	int32 rays = 0;
+	int32 skipped = 0;
+	int32 mismatches = 0;
+	int32 statesSeen[(int32)EViewTargetState::VTS_STEALTH + 1] = {};
+
+	auto CheckRay = [&](const FRotator& Rotation)
+	{
+		controller->SetControlRotation(Rotation);
+		character->UpdateReticleState();
+
+		// an overlapped pickup holds the reticle, the legacy resolver did the same so there's nothing to compare
+		if (character->IsOverlappingPickup)
+		{
+			skipped++;
+			return;
+		}
+
+		EViewTargetState legacyState;
+		FVector legacyAim;
+		character->ResolveReticleStateLegacy(character->GetFirstPersonCameraComponent()->GetComponentLocation(), character->GetControlRotation().Vector(), legacyState, legacyAim);
+
+		rays++;
+		statesSeen[(int32)legacyState]++;
+		if ((legacyState == character->GetReticleState()) && legacyAim.Equals(character->GetAimLocation(), AimTolerance)) return;
+
+		if (++mismatches <= MaxReportedMismatches)
+		{
+			Test->AddError(FString::Printf(TEXT("ray %s from %s: state %d aim %s, legacy state %d aim %s"), *Rotation.ToString(), *character->GetActorLocation().ToString(),
+				(int32)character->GetReticleState(), *character->GetAimLocation().ToString(), (int32)legacyState, *legacyAim.ToString()));
+		}
+	};
+
+	// all around the spawn point
+	for (float pitch = -60.f; pitch <= 60.f; pitch += 5.f)
+	{
+		for (float yaw = 0.f; yaw < 360.f; yaw += 5.f) CheckRay(FRotator(pitch, yaw, 0.f));
+	}
+
+	// across each interactable from inside its interact distance, so the cover and pickup states get exercised too
+	TArray<AActor*> interactables;
+	for (TActorIterator<ACoverActorBase> It(character->GetWorld()); It; ++It) interactables.Add(*It);
+	for (TActorIterator<APickup> It(character->GetWorld()); It; ++It) interactables.Add(*It);
+
+	for (AActor* interactable : interactables)
+	{
+		FVector toCharacter = savedLocation - interactable->GetActorLocation();
+		toCharacter.Z = 0.f;
+		const FVector standLocation = interactable->GetActorLocation() + toCharacter.GetSafeNormal() * 300.f;
+		character->SetActorLocation(FVector(standLocation.X, standLocation.Y, savedLocation.Z), false, nullptr, ETeleportType::TeleportPhysics);
+
+		const FRotator lookAt = (interactable->GetActorLocation() - character->GetFirstPersonCameraComponent()->GetComponentLocation()).Rotation();
+		for (float pitch = -20.f; pitch <= 20.f; pitch += 5.f)
+		{
+			for (float yaw = -20.f; yaw <= 20.f; yaw += 5.f) CheckRay(FRotator(lookAt.Pitch + pitch, lookAt.Yaw + yaw, 0.f));
+		}
+	}
+
+	character->SetActorLocation(savedLocation, false, nullptr, ETeleportType::TeleportPhysics);
+	controller->SetControlRotation(savedRotation);
+	character->bAsyncReticleTrace = bSavedAsync;
+	character->UpdateReticleState();
+
+	if (mismatches > 0) Test->AddError(FString::Printf(TEXT("%d of %d rays resolved differently"), mismatches, rays));
+	Test->AddInfo(FString::Printf(TEXT("%d rays (%d skipped while overlapping a pickup) across %d interactables: default %d, cover %d, ammo %d, health %d, objective %d"),
+		rays, skipped, interactables.Num(), statesSeen[(int32)EViewTargetState::VTS_DEFAULT], statesSeen[(int32)EViewTargetState::VTS_COVER],
+		statesSeen[(int32)EViewTargetState::VTS_AMMO], statesSeen[(int32)EViewTargetState::VTS_HEALTH], statesSeen[(int32)EViewTargetState::VTS_OBJECT]));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmegaReticleEquivalenceTest, "Omega.Reticle.SingleTraceMatchesLegacy", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FOmegaReticleEquivalenceTest::RunTest(const FString& Parameters)
+{
+	OmegaAddLoadTestMapCommands(this);
+	ADD_LATENT_AUTOMATION_COMMAND(FOmegaReticleSweepCommand(this));
+	return true;
+}
+
+#endif
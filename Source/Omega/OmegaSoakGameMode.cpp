@@ -0,0 +1,184 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaSoakGameMode.h"
+#include "Omega.h"
+#include "OmegaBotController.h"
+#include "OmegaCharacter.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/FileManager.h"
+#include "Misc/App.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "UObject/UObjectArray.h"
+#include "RenderCore.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmegaSoak, Log, All);
+
+AOmegaSoakGameMode::AOmegaSoakGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	BotControllerClass = AOmegaBotController::StaticClass();
+}
+
+void AOmegaSoakGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	FParse::Value(FCommandLine::Get(), TEXT("OmegaBots="), NumBots);
+	FParse::Value(FCommandLine::Get(), TEXT("OmegaSoakMinutes="), SoakMinutes);
+
+	SoakStartTime = FPlatformTime::Seconds();
+	NextSampleTime = SoakStartTime + SampleInterval;
+	FirstUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+	TimersArmedAtSample = OmegaStats::TimersArmed;
+
+	CsvPath = FPaths::Combine(FPaths::GameSavedDir(), TEXT("Soak"), FString::Printf(TEXT("%s-%s.csv"), *GetWorld()->GetMapName(), *FDateTime::Now().ToString()));
+	FFileHelper::SaveStringToFile(TEXT("elapsed_s,frames,frame_ms,game_thread_ms,game_thread_ms_max,used_physical_mb,used_virtual_mb,physical_growth_mb,uobjects,actors,bots_alive,deaths,timers_armed\n"), *CsvPath);
+
+	SpawnBots();
+
+	UE_LOG(LogOmegaSoak, Log, TEXT("soaking with %d bots, sampling every %.0fs to %s"), Bots.Num(), SampleInterval, *CsvPath);
+}
+
+void AOmegaSoakGameMode::SpawnBots()
+{
+	UClass* botClass = (BotControllerClass) ? *BotControllerClass : AOmegaBotController::StaticClass();
+
+	for (int32 index = 0; index < NumBots; index++)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Instigator = Instigator;
+		SpawnParams.ObjectFlags |= RF_Transient;
+		AOmegaBotController* bot = GetWorld()->SpawnActor<AOmegaBotController>(botClass, SpawnParams);
+		if (!bot) continue;
+
+		if (bot->PlayerState) bot->PlayerState->SetPlayerName(FString::Printf(TEXT("Bot %d"), index + 1));
+
+		Bots.Add(bot);
+		DeathTimes.Add(-1.f);
+
+		// held back with the players while the preload runs
+		RestartPlayer(bot);
+	}
+}
+
+APawn* AOmegaSoakGameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+	if (!Cast<AOmegaBotController>(NewPlayer)) return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+
+	// maps have a handful of player starts, scatter the bots around them rather than stacking them up
+	FTransform transform = SpawnTransform;
+	transform.AddToTranslation(FVector(FMath::RandPointInCircle(BotSpawnRadius), 0.f));
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Instigator = Instigator;
+	SpawnParams.ObjectFlags |= RF_Transient;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	return GetWorld()->SpawnActor<APawn>(GetDefaultPawnClassForController(NewPlayer), transform, SpawnParams);
+}
+
+void AOmegaSoakGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (bFinished) return;
+
+	// the game thread's own time for the frame, the frame itself is held to the server tick rate
+	const float gameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+	Frames++;
+	FrameSeconds += FApp::GetDeltaTime();
+	GameThreadMsTotal += gameThreadMs;
+	GameThreadMsMax = FMath::Max(GameThreadMsMax, gameThreadMs);
+
+	RespawnBots();
+
+	const double now = FPlatformTime::Seconds();
+	if (now < NextSampleTime) return;
+
+	NextSampleTime = now + SampleInterval;
+	WriteSample();
+
+	if ((SoakMinutes > 0.f) && ((now - SoakStartTime) >= SoakMinutes * 60.0))
+	{
+		bFinished = true;
+		UE_LOG(LogOmegaSoak, Log, TEXT("soak finished after %.0f minutes, results in %s"), SoakMinutes, *CsvPath);
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void AOmegaSoakGameMode::RespawnBots()
+{
+	const float now = GetWorld()->GetTimeSeconds();
+
+	for (int32 index = 0; index < Bots.Num(); index++)
+	{
+		AOmegaBotController* bot = Bots[index];
+		if (!bot) continue;
+
+		AOmegaCharacter* character = Cast<AOmegaCharacter>(bot->GetPawn());
+		// alive, however it got there - a death timer left over from before (a failed respawn, a revive) mustn't carry on
+		if (character && !character->IsDead())
+		{
+			DeathTimes[index] = -1.f;
+			continue;
+		}
+
+		// a fresh body after a while, the old one goes so its guns and components are torn down like a player's
+		if (DeathTimes[index] < 0.f)
+		{
+			DeathTimes[index] = now;
+			if (character) Deaths++;
+			continue;
+		}
+		if ((now - DeathTimes[index]) < RespawnDelay) continue;
+
+		DeathTimes[index] = -1.f;
+		if (character)
+		{
+			bot->UnPossess();
+			character->Destroy();
+		}
+		RestartPlayer(bot);
+	}
+}
+
+void AOmegaSoakGameMode::WriteSample()
+{
+	const FPlatformMemoryStats memory = FPlatformMemory::GetStats();
+	const double toMB = 1.0 / (1024.0 * 1024.0);
+
+	int32 botsAlive = 0;
+	for (AOmegaBotController* bot : Bots)
+	{
+		AOmegaCharacter* character = (bot) ? Cast<AOmegaCharacter>(bot->GetPawn()) : nullptr;
+		if (character && !character->IsDead()) botsAlive++;
+	}
+
+	const FString row = FString::Printf(TEXT("%.1f,%d,%.3f,%.3f,%.3f,%.1f,%.1f,%.1f,%d,%d,%d,%d,%llu\n"),
+		FPlatformTime::Seconds() - SoakStartTime,
+		Frames,
+		(Frames > 0) ? FrameSeconds * 1000.0 / Frames : 0.0,
+		(Frames > 0) ? GameThreadMsTotal / Frames : 0.0,
+		GameThreadMsMax,
+		memory.UsedPhysical * toMB,
+		memory.UsedVirtual * toMB,
+		((double)memory.UsedPhysical - (double)FirstUsedPhysical) * toMB,
+		GUObjectArray.GetObjectArrayNumMinusAvailable(),
+		GetWorld()->GetActorCount(),
+		botsAlive,
+		Deaths,
+		OmegaStats::TimersArmed - TimersArmedAtSample);
+
+	FFileHelper::SaveStringToFile(row, *CsvPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append);
+	UE_LOG(LogOmegaSoak, Log, TEXT("%s"), *row.TrimTrailing());
+
+	Frames = 0;
+	FrameSeconds = 0.0;
+	GameThreadMsTotal = 0.0;
+	GameThreadMsMax = 0.f;
+	Deaths = 0;
+	TimersArmedAtSample = OmegaStats::TimersArmed;
+}
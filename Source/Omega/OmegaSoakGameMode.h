@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmegaGameMode.h"
+#include "OmegaSoakGameMode.generated.h"
+
+class AOmegaBotController;
+
+/**
+ * Long-running load test. Spawns NumBots AOmegaBotControllers, respawns them as they die, and every SampleInterval
+ * appends a row to Saved/Soak/<map>-<time>.csv: server frame and game thread time, memory and its growth since the
+ * first sample, UObject/actor counts and timers armed - enough to spot scaling cliffs and leaks over hours.
+ *
+ * Headless on Linux: OmegaServer <map>?game=Soak -log -OmegaBots=64 -OmegaSoakMinutes=240
+ */
+UCLASS(minimalapi, config=Game)
+class AOmegaSoakGameMode : public AOmegaGameMode
+{
+	GENERATED_BODY()
+
+public:
+	AOmegaSoakGameMode();
+
+	virtual void StartPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+protected:
+	/** overridden by -OmegaBots= */
+	UPROPERTY(Config)
+	int32 NumBots = 32;
+	UPROPERTY(Config)
+	TSubclassOf<AOmegaBotController> BotControllerClass;
+	/** bots spawn scattered this far around the chosen player start */
+	UPROPERTY(Config)
+	float BotSpawnRadius = 1500.f;
+	UPROPERTY(Config)
+	float RespawnDelay = 3.f;
+	/** seconds between CSV rows */
+	UPROPERTY(Config)
+	float SampleInterval = 10.f;
+	/** quits after this long, 0 runs until stopped - overridden by -OmegaSoakMinutes= */
+	UPROPERTY(Config)
+	float SoakMinutes = 0.f;
+
+private:
+	void SpawnBots();
+	void RespawnBots();
+	void WriteSample();
+
+	UPROPERTY()
+	TArray<AOmegaBotController*> Bots;
+	// when each bot was found dead, negative while it's alive
+	TArray<float> DeathTimes;
+
+	FString CsvPath;
+	double SoakStartTime = 0.0;
+	double NextSampleTime = 0.0;
+	uint64 FirstUsedPhysical = 0;
+	bool bFinished = false;
+
+	// accumulated since the last sample
+	int32 Frames = 0;
+	double FrameSeconds = 0.0;
+	double GameThreadMsTotal = 0.0;
+	float GameThreadMsMax = 0.f;
+	int32 Deaths = 0;
+	uint64 TimersArmedAtSample = 0;
+};
@@ -0,0 +1,226 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaTelemetry.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/Paths.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmegaTelemetry, Log, All);
+
+FOmegaTelemetry* FOmegaTelemetry::Instance = nullptr;
+
+void FOmegaTelemetry::StartSession(const FString& SessionName)
+{
+	check(IsInGameThread());
+	if (Instance) StopSession();
+
+	const FString path = FPaths::Combine(FPaths::GameSavedDir(), TEXT("Telemetry"), SessionName + TEXT(".omtl"));
+	FArchive* writer = IFileManager::Get().CreateFileWriter(*path);
+	if (!writer)
+	{
+		UE_LOG(LogOmegaTelemetry, Error, TEXT("couldn't open %s, telemetry is off"), *path);
+		return;
+	}
+
+	uint32 magic = FileMagic;
+	uint16 version = FileVersion;
+	uint16 recordSize = sizeof(FOmegaTelemetryRecord);
+	*writer << magic << version << recordSize;
+
+	Instance = new FOmegaTelemetry(writer);
+	Instance->Thread = FRunnableThread::Create(Instance, TEXT("OmegaTelemetryWriter"), 0, TPri_BelowNormal);
+
+	UE_LOG(LogOmegaTelemetry, Log, TEXT("recording to %s"), *path);
+}
+
+void FOmegaTelemetry::StopSession()
+{
+	check(IsInGameThread());
+	if (!Instance) return;
+
+	// the writer drains whatever is left before its thread finishes
+	FOmegaTelemetry* telemetry = Instance;
+	Instance = nullptr;
+	delete telemetry;
+}
+
+FOmegaTelemetry::FOmegaTelemetry(FArchive* InWriter)
+	: Queue(QueueSize)
+	, Writer(InWriter)
+	, StartTime(FPlatformTime::Seconds())
+{
+}
+
+FOmegaTelemetry::~FOmegaTelemetry()
+{
+	if (Thread)
+	{
+		Thread->Kill(true);
+		delete Thread;
+	}
+
+	if (DroppedRecords > 0) UE_LOG(LogOmegaTelemetry, Warning, TEXT("%u records dropped, the queue was full"), DroppedRecords);
+
+	delete Writer;
+}
+
+uint32 FOmegaTelemetry::Run()
+{
+	while (StopRequested.GetValue() == 0)
+	{
+		WriteRecords();
+		FPlatformProcess::Sleep(0.01f);
+	}
+
+	// the producer has stopped by now, take the rest
+	WriteRecords();
+	Writer->Flush();
+	return 0;
+}
+
+void FOmegaTelemetry::Stop()
+{
+	StopRequested.Set(1);
+}
+
+void FOmegaTelemetry::WriteRecords()
+{
+	FOmegaTelemetryRecord record;
+	while (Queue.Dequeue(record))
+	{
+		Writer->Serialize(&record, sizeof(record));
+	}
+}
+
+void FOmegaTelemetry::Push(const FOmegaTelemetryRecord& Record)
+{
+	// report drops in order, as soon as there's room again
+	if (DroppedRecords > 0)
+	{
+		FOmegaTelemetryRecord dropped;
+		FMemory::Memzero(dropped);
+		dropped.Type = EOmegaTelemetryRecord::Dropped;
+		dropped.Time = Record.Time;
+		dropped.Source = DroppedRecords;
+
+		if (!Queue.Enqueue(dropped))
+		{
+			DroppedRecords++;
+			return;
+		}
+		DroppedRecords = 0;
+	}
+
+	if (!Queue.Enqueue(Record)) DroppedRecords++;
+}
+
+uint32 FOmegaTelemetry::GetId(const AActor* Actor)
+{
+	if (!Actor) return 0;
+
+	const TWeakObjectPtr<const AActor> key(Actor);
+	if (const uint32* id = ActorIds.Find(key)) return *id;
+
+	if (ActorIds.Num() >= ActorIdsPruneSize)
+	{
+		for (auto It = ActorIds.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid()) It.RemoveCurrent();
+		}
+		ActorIdsPruneSize = FMath::Max(ActorIdsPruneSize, ActorIds.Num() * 2);
+	}
+
+	const uint32 id = NextActorId++;
+	ActorIds.Add(key, id);
+
+	// the first record to mention an actor names it, players by their player name
+	const APawn* pawn = Cast<APawn>(Actor);
+	const FString name = (pawn && pawn->PlayerState) ? pawn->PlayerState->PlayerName : Actor->GetName();
+
+	FOmegaTelemetryRecord record;
+	FMemory::Memzero(record);
+	record.Type = EOmegaTelemetryRecord::Name;
+	record.Time = (float)(FPlatformTime::Seconds() - StartTime);
+	record.Source = id;
+	FCStringAnsi::Strncpy(record.Name, TCHAR_TO_ANSI(*name), FOmegaTelemetryRecord::MaxNameLength);
+	Push(record);
+
+	return id;
+}
+
+void FOmegaTelemetry::RecordShot(const AActor* Shooter, const AActor* Weapon, uint8 FireMode, int32 AutoFireCount, float Spread, const FVector& AimLocation, const FVector& MuzzleLocation)
+{
+	if (!Instance) return;
+
+	FOmegaTelemetryRecord record;
+	record.Type = EOmegaTelemetryRecord::Shot;
+	record.FireMode = FireMode;
+	record.AutoFireCount = (uint16)FMath::Clamp(AutoFireCount, 0, (int32)MAX_uint16);
+	record.Time = (float)(FPlatformTime::Seconds() - Instance->StartTime);
+	record.Source = Instance->GetId(Shooter);
+	record.Combat.Target = 0;
+	record.Combat.Weapon = Instance->GetId(Weapon);
+	record.Combat.Value = Spread;
+	record.Combat.Extra = 0.f;
+	record.Combat.Location[0] = AimLocation.X;
+	record.Combat.Location[1] = AimLocation.Y;
+	record.Combat.Location[2] = AimLocation.Z;
+	record.Combat.Origin[0] = MuzzleLocation.X;
+	record.Combat.Origin[1] = MuzzleLocation.Y;
+	record.Combat.Origin[2] = MuzzleLocation.Z;
+	Instance->Push(record);
+}
+
+void FOmegaTelemetry::RecordSecondaryShot(const AActor* Shooter, const AActor* Weapon, const FVector& AimLocation, const FVector& MuzzleLocation)
+{
+	if (!Instance) return;
+
+	FOmegaTelemetryRecord record;
+	FMemory::Memzero(record);
+	record.Type = EOmegaTelemetryRecord::SecondaryShot;
+	record.Time = (float)(FPlatformTime::Seconds() - Instance->StartTime);
+	record.Source = Instance->GetId(Shooter);
+	record.Combat.Weapon = Instance->GetId(Weapon);
+	record.Combat.Location[0] = AimLocation.X;
+	record.Combat.Location[1] = AimLocation.Y;
+	record.Combat.Location[2] = AimLocation.Z;
+	record.Combat.Origin[0] = MuzzleLocation.X;
+	record.Combat.Origin[1] = MuzzleLocation.Y;
+	record.Combat.Origin[2] = MuzzleLocation.Z;
+	Instance->Push(record);
+}
+
+void FOmegaTelemetry::RecordHit(const AActor* Instigator, const AActor* Weapon, const AActor* HitActor, const FVector& HitLocation)
+{
+	if (!Instance) return;
+
+	FOmegaTelemetryRecord record;
+	FMemory::Memzero(record);
+	record.Type = EOmegaTelemetryRecord::Hit;
+	record.Time = (float)(FPlatformTime::Seconds() - Instance->StartTime);
+	record.Source = Instance->GetId(Instigator);
+	record.Combat.Target = Instance->GetId(HitActor);
+	record.Combat.Weapon = Instance->GetId(Weapon);
+	record.Combat.Location[0] = HitLocation.X;
+	record.Combat.Location[1] = HitLocation.Y;
+	record.Combat.Location[2] = HitLocation.Z;
+	Instance->Push(record);
+}
+
+void FOmegaTelemetry::RecordDamage(const AActor* Victim, float HealthLost, float ShieldAbsorbed)
+{
+	if (!Instance) return;
+
+	FOmegaTelemetryRecord record;
+	FMemory::Memzero(record);
+	record.Type = EOmegaTelemetryRecord::Damage;
+	record.Time = (float)(FPlatformTime::Seconds() - Instance->StartTime);
+	record.Combat.Target = Instance->GetId(Victim);
+	record.Combat.Value = HealthLost;
+	record.Combat.Extra = ShieldAbsorbed;
+	Instance->Push(record);
+}
@@ -0,0 +1,113 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/Runnable.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+enum class EOmegaTelemetryRecord : uint8
+{
+	Shot,
+	Hit,
+	Damage,
+	// names the id in Source for the rest of the session
+	Name,
+	// Source holds the number of records dropped because the queue was full
+	Dropped,
+	// laid out like Shot, fire mode and auto fire count unused
+	SecondaryShot
+};
+
+/** one fixed-size record, written to the session file exactly as laid out here */
+struct FOmegaTelemetryRecord
+{
+	EOmegaTelemetryRecord Type;
+	uint8 FireMode;
+	uint16 AutoFireCount;
+	// seconds since the session started
+	float Time;
+	uint32 Source;
+
+	struct FCombat
+	{
+		uint32 Target;
+		uint32 Weapon;
+		// shots: spread extent, secondary shots and hits: unused, damage: health lost after shield and armor
+		float Value;
+		// damage: shield absorbed
+		float Extra;
+		// shots: aim location, hits: hit location
+		float Location[3];
+		// shots and secondary shots: muzzle location
+		float Origin[3];
+	};
+
+	static constexpr int32 MaxNameLength = sizeof(FCombat);
+
+	union
+	{
+		FCombat Combat;
+		ANSICHAR Name[MaxNameLength];
+	};
+};
+static_assert(sizeof(FOmegaTelemetryRecord) == 52, "the session file format depends on the record layout");
+
+/**
+ * Combat telemetry. The game thread is the only producer: each event is a fixed-size record pushed into a lock-free
+ * single-producer/single-consumer ring, and a background thread drains the ring into Saved/Telemetry/<session>.omtl.
+ * A full ring drops records (and says so in the file) rather than ever blocking the game thread.
+ *
+ * Enabled with -OmegaTelemetry, convert a session to CSV with -run=OmegaTelemetryToCsv.
+ */
+class OMEGA_API FOmegaTelemetry : public FRunnable
+{
+public:
+	static constexpr uint32 FileMagic = 0x4C544D4F; // "OMTL"
+	// 2 added secondary shots, version 1 sessions still read
+	static constexpr uint16 FileVersion = 2;
+
+	static void StartSession(const FString& SessionName);
+	static void StopSession();
+
+	static FORCEINLINE bool IsRecording() { return Instance != nullptr; }
+
+	/** game thread only */
+	static void RecordShot(const AActor* Shooter, const AActor* Weapon, uint8 FireMode, int32 AutoFireCount, float Spread, const FVector& AimLocation, const FVector& MuzzleLocation);
+	static void RecordSecondaryShot(const AActor* Shooter, const AActor* Weapon, const FVector& AimLocation, const FVector& MuzzleLocation);
+	static void RecordHit(const AActor* Instigator, const AActor* Weapon, const AActor* HitActor, const FVector& HitLocation);
+	static void RecordDamage(const AActor* Victim, float HealthLost, float ShieldAbsorbed);
+
+	virtual ~FOmegaTelemetry();
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	FOmegaTelemetry(FArchive* InWriter);
+
+	uint32 GetId(const AActor* Actor);
+	void Push(const FOmegaTelemetryRecord& Record);
+	void WriteRecords();
+
+	static FOmegaTelemetry* Instance;
+
+	// ring capacity, a few seconds of a busy firefight
+	static constexpr uint32 QueueSize = 8192;
+
+	TCircularQueue<FOmegaTelemetryRecord> Queue;
+	FArchive* Writer;
+	FRunnableThread* Thread = nullptr;
+	FThreadSafeCounter StopRequested;
+
+	// producer side only. ids are handed out per session - object indices get reused once an actor is collected, a
+	// weak pointer to a collected actor never matches its successor. stale entries are pruned as the map grows
+	double StartTime;
+	TMap<TWeakObjectPtr<const AActor>, uint32> ActorIds;
+	uint32 NextActorId = 1;
+	int32 ActorIdsPruneSize = 256;
+	uint32 DroppedRecords = 0;
+};
@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaAutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "OmegaTelemetry.h"
+#include "OmegaCharacter.h"
+#include "OmegaGunBase.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// the budget the ring is meant to hold the game thread to, per recorded event
+	const double BudgetNs = 500.0;
+	// well inside the ring, the writer drains it between batches so nothing is dropped
+	const int32 EventsPerBatch = 2048;
+	const int32 Batches = 16;
+	const float DrainSeconds = 0.05f;
+}
+
+/**
+ * Records batches of shots, hits and damage for the player and their gun into a session of its own, timing each batch
+ * on the game thread. The median batch, per event, is what's compared against the budget.
+ */
+DEFINE_LATENT_AUTOMATION_COMMAND_ONE_PARAMETER(FOmegaTelemetryOverheadCommand, FAutomationTestBase*, Test);
+
+bool FOmegaTelemetryOverheadCommand::Update()
+{
+	AOmegaCharacter* character = OmegaTests::GetPlayerCharacter();
+	AOmegaGunBase* weapon = (character) ? character->GetCurrentWeapon() : nullptr;
+	if (!weapon)
+	{
+		if (character) Test->AddError(TEXT("the player has no weapon in hand"));
+		return true;
+	}
+
+	// a session started with -OmegaTelemetry isn't ours to end
+	if (FOmegaTelemetry::IsRecording())
+	{
+		Test->AddWarning(TEXT("a telemetry session is already recording, not measured"));
+		return true;
+	}
+
+	const FString sessionName = TEXT("AutomationOverhead");
+	FOmegaTelemetry::StartSession(sessionName);
+	if (!FOmegaTelemetry::IsRecording())
+	{
+		Test->AddError(TEXT("couldn't start a telemetry session"));
+		return true;
+	}
+
+	const FVector aim = character->GetAimLocation();
+	const FVector muzzle = weapon->GetActorLocation();
+
+	TArray<double> batchNs;
+	for (int32 batch = 0; batch < Batches; batch++)
+	{
+		const uint32 startCycles = FPlatformTime::Cycles();
+		for (int32 event = 0; event < EventsPerBatch; event += 4)
+		{
+			FOmegaTelemetry::RecordShot(character, weapon, 0, event, 0.f, aim, muzzle);
+			FOmegaTelemetry::RecordSecondaryShot(character, weapon, aim, muzzle);
+			FOmegaTelemetry::RecordHit(character, weapon, character, aim);
+			FOmegaTelemetry::RecordDamage(character, 1.f, 0.f);
+		}
+		batchNs.Add(FPlatformTime::ToMilliseconds(FPlatformTime::Cycles() - startCycles) * 1000000.0 / EventsPerBatch);
+
+		FPlatformProcess::Sleep(DrainSeconds);
+	}
+
+	FOmegaTelemetry::StopSession();
+	IFileManager::Get().Delete(*FPaths::Combine(FPaths::GameSavedDir(), TEXT("Telemetry"), sessionName + TEXT(".omtl")));
+
+	batchNs.Sort();
+	const double medianNs = batchNs[batchNs.Num() / 2];
+	const FString result = FString::Printf(TEXT("%.0f ns per event (median of %d batches of %d, worst batch %.0f ns), budget %.0f ns"), medianNs, Batches, EventsPerBatch, batchNs.Last(), BudgetNs);
+
+	if (medianNs > BudgetNs) Test->AddError(result);
+	else Test->AddInfo(result);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmegaTelemetryOverheadTest, "Omega.Telemetry.RecordingOverhead", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FOmegaTelemetryOverheadTest::RunTest(const FString& Parameters)
+{
+	OmegaAddLoadTestMapCommands(this);
+	ADD_LATENT_AUTOMATION_COMMAND(FOmegaTelemetryOverheadCommand(this));
+	return true;
+}
+
+#endif
@@ -0,0 +1,107 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "OmegaTelemetryToCsvCommandlet.h"
+#include "OmegaTelemetry.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/Class.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmegaTelemetryToCsv, Log, All);
+
+UOmegaTelemetryToCsvCommandlet::UOmegaTelemetryToCsvCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UOmegaTelemetryToCsvCommandlet::Main(const FString& Params)
+{
+	FString inPath;
+	if (!FParse::Value(*Params, TEXT("in="), inPath))
+	{
+		UE_LOG(LogOmegaTelemetryToCsv, Error, TEXT("usage: -run=OmegaTelemetryToCsv -in=<session>.omtl [-out=<file>.csv]"));
+		return 1;
+	}
+
+	FString outPath;
+	if (!FParse::Value(*Params, TEXT("out="), outPath)) outPath = FPaths::ChangeExtension(inPath, TEXT("csv"));
+
+	TArray<uint8> data;
+	if (!FFileHelper::LoadFileToArray(data, *inPath))
+	{
+		UE_LOG(LogOmegaTelemetryToCsv, Error, TEXT("couldn't read %s"), *inPath);
+		return 1;
+	}
+
+	// header: magic, version, record size
+	const int32 headerSize = sizeof(uint32) + sizeof(uint16) + sizeof(uint16);
+	uint32 magic = 0;
+	uint16 version = 0;
+	uint16 recordSize = 0;
+	if (data.Num() >= headerSize)
+	{
+		FMemory::Memcpy(&magic, data.GetData(), sizeof(magic));
+		FMemory::Memcpy(&version, data.GetData() + sizeof(magic), sizeof(version));
+		FMemory::Memcpy(&recordSize, data.GetData() + sizeof(magic) + sizeof(version), sizeof(recordSize));
+	}
+
+	// newer versions only ever add record types, older sessions read as they are
+	if ((magic != FOmegaTelemetry::FileMagic) || (version < 1) || (version > FOmegaTelemetry::FileVersion) || (recordSize != sizeof(FOmegaTelemetryRecord)))
+	{
+		UE_LOG(LogOmegaTelemetryToCsv, Error, TEXT("%s isn't a telemetry session of version %d or older"), *inPath, (int32)FOmegaTelemetry::FileVersion);
+		return 1;
+	}
+
+	static const TCHAR* const typeNames[] = { TEXT("shot"), TEXT("hit"), TEXT("damage"), TEXT("name"), TEXT("dropped"), TEXT("secondary_shot") };
+	const UEnum* fireModeEnum = FindObject<UEnum>(ANY_PACKAGE, TEXT("EFireMode"), true);
+
+	TMap<uint32, FString> names;
+	auto nameOf = [&names](uint32 Id) { const FString* name = names.Find(Id); return (name) ? *name : FString(); };
+
+	FString csv = TEXT("time,type,source,source_name,target,target_name,weapon,weapon_name,fire_mode,auto_fire_count,value,extra,x,y,z,origin_x,origin_y,origin_z\n");
+	int32 rows = 0;
+
+	// a session cut short can end mid-record, the partial one is ignored
+	for (int32 offset = headerSize; offset + recordSize <= data.Num(); offset += recordSize)
+	{
+		FOmegaTelemetryRecord record;
+		FMemory::Memcpy(&record, data.GetData() + offset, sizeof(record));
+
+		if (record.Type == EOmegaTelemetryRecord::Name)
+		{
+			record.Name[FOmegaTelemetryRecord::MaxNameLength - 1] = 0;
+			names.Add(record.Source, ANSI_TO_TCHAR(record.Name));
+			continue;
+		}
+
+		if ((uint8)record.Type >= ARRAY_COUNT(typeNames)) continue;
+
+		const FOmegaTelemetryRecord::FCombat& combat = record.Combat;
+		const bool bIsDropped = (record.Type == EOmegaTelemetryRecord::Dropped);
+		const bool bIsShot = (record.Type == EOmegaTelemetryRecord::Shot);
+		const FString fireMode = (bIsShot && fireModeEnum) ? fireModeEnum->GetNameStringByValue(record.FireMode) : FString();
+
+		csv += FString::Printf(TEXT("%.4f,%s,%u,%s,%u,%s,%u,%s,%s,%d,%.3f,%.3f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f\n"),
+			record.Time, typeNames[(uint8)record.Type],
+			record.Source, (bIsDropped) ? TEXT("") : *nameOf(record.Source),
+			(bIsDropped) ? 0 : combat.Target, (bIsDropped) ? TEXT("") : *nameOf(combat.Target),
+			(bIsDropped) ? 0 : combat.Weapon, (bIsDropped) ? TEXT("") : *nameOf(combat.Weapon),
+			*fireMode, (int32)record.AutoFireCount,
+			combat.Value, combat.Extra,
+			combat.Location[0], combat.Location[1], combat.Location[2],
+			combat.Origin[0], combat.Origin[1], combat.Origin[2]);
+		rows++;
+	}
+
+	if (!FFileHelper::SaveStringToFile(csv, *outPath))
+	{
+		UE_LOG(LogOmegaTelemetryToCsv, Error, TEXT("couldn't write %s"), *outPath);
+		return 1;
+	}
+
+	UE_LOG(LogOmegaTelemetryToCsv, Log, TEXT("%d rows written to %s"), rows, *outPath);
+	return 0;
+}
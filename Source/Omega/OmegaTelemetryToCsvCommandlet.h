@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "OmegaTelemetryToCsvCommandlet.generated.h"
+
+/**
+ * Converts a combat telemetry session (see FOmegaTelemetry) to CSV, one row per record with ids resolved to names.
+ *
+ * UE4Editor-Cmd Omega -run=OmegaTelemetryToCsv -in=<session>.omtl [-out=<file>.csv]
+ */
+UCLASS()
+class UOmegaTelemetryToCsvCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UOmegaTelemetryToCsvCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,114 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "OmegaWeaponArchetype.generated.h"
+
+UENUM(BlueprintType)
+enum class EFireMode : uint8
+{
+	FM_Single	UMETA(DisplayName = "Semi-automatic"),
+	FM_Burst	UMETA(DisplayName = "Burst-fire"),
+	FM_Auto		UMETA(DisplayName = "Automatic")
+};
+
+UENUM(BlueprintType)
+enum class EProjectileBackend : uint8
+{
+	PB_Actor	UMETA(DisplayName = "Spawned Actor"),
+	PB_Pooled	UMETA(DisplayName = "Pooled Actor"),
+	PB_Simulated	UMETA(DisplayName = "Simulated Bullet")
+};
+
+/**
+ * Immutable weapon tuning, shared by every gun that points at it. Guns only carry their own ammo, charges and fire
+ * cycle state - spawning one copies a pointer, and swapping a gun's archetype changes its whole configuration at once.
+ */
+UCLASS(BlueprintType)
+class OMEGA_API UOmegaWeaponArchetype : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/* ammo and reloading */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo", meta = (ClampMin = "0.0", ClampMax = "3000.0"))
+	int32 totalAmmoMax = 100;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo", meta = (ClampMin = "0.0", ClampMax = "3000.0"))
+	int32 clipAmmoMax = 25;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo", meta = (ClampMin = "0.0"))
+	float ReloadDuration = 1.2f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo", meta = (ClampMin = "0.0", ClampMax = "10.0"))
+	int32 clipSecondaryChargeMax = 2;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Ammo")
+	float SecondaryRechargeTimer = 3.f;
+
+	/** Projectile class to spawn, hitscan when unset */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	TSubclassOf<class AOmegaProjectile> ProjectileClass;
+	/** Projectile class to spawn for secondary fire, a primary shot when unset */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	TSubclassOf<class AOmegaProjectile> SecondaryProjectileClass;
+
+	/**
+	 * how primary/secondary projectiles are brought into the world - pooled actors avoid a spawn and destroy per shot,
+	 * simulated bullets have no actor at all and are advanced by the world's bullet manager
+	 */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	EProjectileBackend ProjectileBackend = EProjectileBackend::PB_Actor;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Projectile)
+	EProjectileBackend SecondaryProjectileBackend = EProjectileBackend::PB_Actor;
+
+	/** Sound to play each time we fire */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Gameplay)
+	class USoundBase* PrimaryFireSound;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Gameplay)
+	class USoundBase* SecondaryFireSound;
+
+	/* trigger configuration */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Configuration")
+	EFireMode TriggerConfig = EFireMode::FM_Single;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Configuration")
+	float SingleFireRate = 0.5f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Configuration")
+	float AutoFireRate = 0.1f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Configuration")
+	int32 BurstCount = 2;
+
+	/* recoil/spread */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Spread")
+	float BurstFireSpread = 5.f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Spread")
+	int32 AutoFireSpreadThreshold = 3;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Weapon Spread")
+	float MaxAutoFireSpread = 30.f;
+
+	/* hitscan */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gun")
+	float DefaultHitscanDamage = 10.f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gun")
+	float DefaultHitscanForce = 100000.f;
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gun")
+	float HitscanRangeBuffer = 50.f;
+
+	/** rays per hitscan shot, anything above one spreads the shot shotgun-style and damage is dealt per target, not per pellet */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gun", meta = (ClampMin = 1, ClampMax = 32))
+	int32 PelletCount = 1;
+	/** half angle, in degrees, of the cone pellets are spread over */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gun", meta = (ClampMin = 0.f, ClampMax = 45.f))
+	float PelletSpreadAngle = 5.f;
+
+	/** upper bound, in seconds, on how far a remote shooter's hitscan shots rewind other characters on the server */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Gun", meta = (ClampMin = 0.f, ClampMax = 1.f))
+	float MaxLagCompensationTime = 0.25f;
+
+	/* networking */
+
+	/** predicted shots the owning client may have awaiting confirmation before it holds fire */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking", meta = (ClampMin = 1, ClampMax = 64))
+	int32 MaxPendingShots = 16;
+	/** fraction of the fire rate the server still accepts between shot requests, absorbs network jitter */
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Networking", meta = (ClampMin = 0.1f, ClampMax = 1.f))
+	float ServerFireRateTolerance = 0.75f;
+};
@@ -3,6 +3,10 @@
 #include "Pickup.h"
 #include "Components/StaticMeshComponent.h"
 #include "OmegaCharacter.h"
+#include "OmegaInteractableRegistry.h"
+#include "Omega.h"
+
+DECLARE_CYCLE_STAT(TEXT("Pickup Overlaps"), STAT_OmegaPickupOverlap, STATGROUP_Omega);
 
 // Sets default values
 APickup::APickup()
@@ -15,7 +19,7 @@ APickup::APickup()
 
 	PickupComp = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Pickup"));
 	PickupComp->SetupAttachment(RootComponent);
-	PickupComp->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+	PickupComp->SetCollisionProfileName(TEXT("Interactable"));
 
 	PickupComp->OnComponentBeginOverlap.AddDynamic(this, &APickup::OnOverlapStart);
 	PickupComp->OnComponentEndOverlap.AddDynamic(this, &APickup::OnOverlapEnd);
@@ -25,7 +29,15 @@ APickup::APickup()
 void APickup::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	FOmegaInteractableRegistry::Get(GetWorld()).Register(this, ReticleTag);
+}
+
+void APickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FOmegaInteractableRegistry::Get(GetWorld()).Unregister(this);
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void APickup::Pickup(class AOmegaCharacter* ActingPlayer)
@@ -35,6 +47,8 @@ void APickup::Pickup(class AOmegaCharacter* ActingPlayer)
 
 void APickup::OnOverlapStart(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult & SweepResult)
 {
+	SCOPE_CYCLE_COUNTER(STAT_OmegaPickupOverlap);
+
 	AOmegaCharacter* OverlappedActor = Cast<AOmegaCharacter>(OtherActor);
 
 	if (OverlappedActor) OverlappedActor->SetOverlappingReticle(this);
@@ -42,6 +56,8 @@ void APickup::OnOverlapStart(UPrimitiveComponent* OverlappedComponent, AActor* O
 
 void APickup::OnOverlapEnd(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
 {
+	SCOPE_CYCLE_COUNTER(STAT_OmegaPickupOverlap);
+
 	AOmegaCharacter* OverlappedActor = Cast<AOmegaCharacter>(OtherActor);
 
 	if (OverlappedActor) OverlappedActor->ClearOverlappingReticle();
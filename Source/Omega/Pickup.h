@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "OmegaCharacter.h"
 #include "Pickup.generated.h"
 
 UCLASS()
@@ -18,12 +19,17 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 	class USceneComponent* BaseComp;
 
 	UPROPERTY(VisibleAnywhere, Category = "Pickup")
 	class UStaticMeshComponent* PickupComp;
 
+	/** reticle state shown when this pickup is targeted or overlapped, set by each pickup type */
+	UPROPERTY(VisibleDefaultsOnly, BlueprintReadOnly, Category = "Pickup")
+	EViewTargetState ReticleTag = EViewTargetState::VTS_DEFAULT;
+
 public:
 	UFUNCTION(BlueprintCallable, Category = "Pickup")
 	virtual void OnOverlapStart(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult & SweepResult);
@@ -32,4 +38,6 @@ public:
 
 	UFUNCTION(BlueprintCallable, Category = "Pickup")
 	virtual void Pickup(class AOmegaCharacter* ActingPlayer);
+
+	FORCEINLINE EViewTargetState GetReticleTag() const { return ReticleTag; }
 };
@@ -0,0 +1,13 @@
+// Copyright 1998-2017 Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class OmegaServerTarget : TargetRules
+{
+	public OmegaServerTarget(TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		ExtraModuleNames.Add("Omega");
+	}
+}